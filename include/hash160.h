@@ -0,0 +1,21 @@
+/*
+ * Hash160 = RIPEMD160(SHA256(x)) for HASH256_PTX
+ * The public key hash behind Bitcoin P2PKH/P2WPKH addresses
+ */
+
+#ifndef HASH160_H
+#define HASH160_H
+
+#include <stdint.h>
+#include <string.h>
+
+// Single message
+void Hash160(const uint8_t* data, size_t len, uint8_t hash[20]);
+
+// Fused batch over count messages of len bytes each, stored back to back
+// (e.g. 33-byte compressed public keys). SHA256 runs lane-parallel and its
+// eight state words feed RIPEMD-160's single 32-byte-input block directly,
+// so the intermediate digest never goes through memory as bytes.
+void Hash160Batch(const uint8_t* data, size_t len, uint8_t* hashes, size_t count);
+
+#endif // HASH160_H
@@ -0,0 +1,39 @@
+/*
+ * Bitcoin block-header nonce sweep for HASH256_PTX
+ *
+ * A header is 80 bytes: the first SHA256 block never changes while the
+ * nonce (bytes 76..79, word 3 of the second block) is swept, so its midstate
+ * is computed once. The second block and the 32-byte second hash of SHA256d
+ * go through fixed-prefix descriptors (sha256_prefix.h): the nonce-free
+ * rounds and schedule terms are computed once per sweep and the rest runs
+ * lane-parallel, split across worker threads.
+ */
+
+#ifndef HEADER_SWEEP_H
+#define HEADER_SWEEP_H
+
+#include <stdint.h>
+#include <string.h>
+
+#define BLOCK_HEADER_SIZE  80
+#define BLOCK_HEADER_NONCE 76
+
+// SHA256d of an 80-byte header (digest bytes as hashed; Bitcoin displays
+// them reversed)
+void HeaderHash(const uint8_t header[80], uint8_t hash[32]);
+
+// Expand a compact nBits value into a 256-bit target, little-endian like
+// the hash it is compared with. Negative or overflowing encodings give zero.
+void HeaderTargetFromBits(uint32_t bits, uint8_t target[32]);
+
+// Proof-of-work test: hash and target read as little-endian 256-bit numbers
+bool HeaderHashMeetsTarget(const uint8_t hash[32], const uint8_t target[32]);
+
+// Try nonces nonce_start .. nonce_start + count - 1 (wrapping at 2^32; count
+// at most 2^32) in header and collect the ones whose SHA256d meets target,
+// in ascending sweep order. num_threads 0 uses every hardware thread. Up to
+// max_nonces are stored; returns the total number found.
+size_t HeaderSweep(const uint8_t header[80], const uint8_t target[32], uint32_t nonce_start, uint64_t count,
+                   uint32_t* nonces, size_t max_nonces, unsigned num_threads = 0);
+
+#endif // HEADER_SWEEP_H
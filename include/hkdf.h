@@ -0,0 +1,47 @@
+/*
+ * HKDF-SHA256 (RFC 5869) for HASH256_PTX
+ *
+ * Extract is one HMAC keyed by the salt. Expand computes
+ * T(i) = HMAC(PRK, T(i-1) || info || i) with the PRK's pad midstates set up
+ * once (HMACSHA256Key) for every block. HKDFExpander streams the output
+ * into caller buffers in pieces of any size, with no allocation.
+ */
+
+#ifndef HKDF_H
+#define HKDF_H
+
+#include <stdint.h>
+#include <string.h>
+#include "hmac_sha256.h"
+
+#define HKDF_MAX_OUTPUT (255 * 32)
+
+// PRK = HMAC(salt, ikm); an empty salt means 32 zero bytes
+void HKDFExtract(const uint8_t* salt, size_t salt_len, const uint8_t* ikm, size_t ikm_len, uint8_t prk[32]);
+
+// Streaming expand. info is referenced, not copied, and must outlive the
+// expander.
+struct HKDFExpander {
+    HMACSHA256Key prk;
+    const uint8_t* info;
+    size_t info_len;
+    uint8_t block[32];            // T(counter)
+    uint32_t counter;             // blocks produced so far
+    size_t used;                  // bytes of block already handed out
+};
+
+void HKDFExpandInit(HKDFExpander& ctx, const uint8_t* prk, size_t prk_len, const uint8_t* info, size_t info_len);
+
+// Next len bytes of output. Returns false, writing nothing, if that would
+// go past HKDF_MAX_OUTPUT bytes in total.
+bool HKDFExpandRead(HKDFExpander& ctx, uint8_t* out, size_t len);
+
+// One-shot expand of okm_len <= HKDF_MAX_OUTPUT bytes
+bool HKDFExpand(const uint8_t* prk, size_t prk_len, const uint8_t* info, size_t info_len,
+                uint8_t* okm, size_t okm_len);
+
+// Extract then expand
+bool HKDF(const uint8_t* salt, size_t salt_len, const uint8_t* ikm, size_t ikm_len,
+          const uint8_t* info, size_t info_len, uint8_t* okm, size_t okm_len);
+
+#endif // HKDF_H
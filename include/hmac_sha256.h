@@ -0,0 +1,33 @@
+/*
+ * HMAC-SHA256 for HASH256_PTX
+ *
+ * HMAC(K, m) = SHA256((K ^ opad) || SHA256((K ^ ipad) || m)). Both padded
+ * keys are exactly one block, so an HMACSHA256Key keeps the inner and outer
+ * midstates. The outer hash is then always one block: the inner digest plus
+ * fixed padding for 96 bytes, which is held as a SHA256Prefix with the eight
+ * digest words varying. A MAC costs the message blocks plus that one block.
+ */
+
+#ifndef HMAC_SHA256_H
+#define HMAC_SHA256_H
+
+#include <stdint.h>
+#include <string.h>
+#include "sha256_prefix.h"
+
+struct HMACSHA256Key {
+    uint32_t inner[8];            // state after K ^ ipad
+    SHA256Prefix outer;           // outer block from the K ^ opad state
+};
+
+// Keys longer than 64 bytes are hashed first, as RFC 2104 requires
+void HMACSHA256KeyInit(HMACSHA256Key& key, const uint8_t* data, size_t len);
+
+void HMACSHA256(const HMACSHA256Key& key, const uint8_t* msg, size_t len, uint8_t mac[32]);
+void HMACSHA256(const uint8_t* key, size_t key_len, const uint8_t* msg, size_t len, uint8_t mac[32]);
+
+// count messages of len bytes each, stored back to back, under one key.
+// SHA256_LANES messages at a time for both the inner and the outer hash.
+void HMACSHA256Batch(const HMACSHA256Key& key, const uint8_t* msgs, size_t len, uint8_t* macs, size_t count);
+
+#endif // HMAC_SHA256_H
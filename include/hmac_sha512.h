@@ -0,0 +1,32 @@
+/*
+ * HMAC-SHA512 for HASH256_PTX
+ *
+ * As hmac_sha256.h with SHA512: the padded key is one 128-byte block, so an
+ * HMACSHA512Key keeps the inner and outer midstates and the outer hash is
+ * always a single block (64-byte inner digest plus padding for 192 bytes).
+ * This is the MAC behind BIP32 child-key derivation and BIP39 seeds.
+ */
+
+#ifndef HMAC_SHA512_H
+#define HMAC_SHA512_H
+
+#include <stdint.h>
+#include <string.h>
+
+struct HMACSHA512Key {
+    uint64_t inner[8];            // state after K ^ ipad
+    uint64_t outer[8];            // state after K ^ opad
+};
+
+// Keys longer than 128 bytes are hashed first, as RFC 2104 requires
+void HMACSHA512KeyInit(HMACSHA512Key& key, const uint8_t* data, size_t len);
+
+void HMACSHA512(const HMACSHA512Key& key, const uint8_t* msg, size_t len, uint8_t mac[64]);
+void HMACSHA512(const uint8_t* key, size_t key_len, const uint8_t* msg, size_t len, uint8_t mac[64]);
+
+// count messages of len bytes each, stored back to back, under one key
+// (e.g. the 37-byte BIP32 data of sibling child indices under one chain
+// code). SHA512_LANES messages at a time.
+void HMACSHA512Batch(const HMACSHA512Key& key, const uint8_t* msgs, size_t len, uint8_t* macs, size_t count);
+
+#endif // HMAC_SHA512_H
@@ -0,0 +1,64 @@
+/*
+ * On-device key enumeration layout for HASH256_PTX
+ *
+ * Counter-mode kernels (generated with --input-mode counter) build their
+ * 33-byte inputs on the GPU instead of reading them from memory: each key is
+ * a fixed base record with a 64-bit counter (start + key index) written
+ * little-endian into a chosen set of bytes. The functions here are the CPU
+ * reference for that enumeration and prepare the kernel's base parameter.
+ */
+
+#ifndef KEY_COUNTER_H
+#define KEY_COUNTER_H
+
+#include <stdint.h>
+#include <string.h>
+#include "sha256_prefix.h"
+
+#define KEY_COUNTER_KEY_SIZE  33
+#define KEY_COUNTER_MAX_BYTES 8
+
+// Counter byte i (bits 8i..8i+7) is stored at key byte positions[i].
+// Counter bits above num_bytes * 8 are dropped, so the enumeration wraps.
+struct KeyCounterLayout {
+    uint32_t num_bytes;
+    uint32_t positions[KEY_COUNTER_MAX_BYTES];
+};
+
+// Layout of the benchmark's generated keys: byte 31 = i & 0xff, byte 32 = i >> 8
+extern const KeyCounterLayout KEY_COUNTER_DEFAULT_LAYOUT;
+
+// 1..8 counter bytes at distinct positions inside a 33-byte key
+bool KeyCounterLayoutValid(const KeyCounterLayout& layout);
+bool KeyCounterLayoutEqual(const KeyCounterLayout& a, const KeyCounterLayout& b);
+
+// Write counter value into key according to layout
+void KeyCounterApply(uint8_t* key, const KeyCounterLayout& layout, uint64_t value);
+
+// Keys start .. start + count - 1, written back to back (33 bytes each)
+void KeyCounterEnumerate(const uint8_t base[33], const KeyCounterLayout& layout,
+                         uint64_t start, uint8_t* keys, size_t count);
+
+// Reference SHA256 digests (byte layout) of the same keys
+void KeyCounterHashBatch(const uint8_t base[33], const KeyCounterLayout& layout,
+                         uint64_t start, uint8_t* hashes, size_t count);
+
+// Kernel base parameter: the key as 9 big-endian words with the SHA256 0x80
+// pad byte after it and the counter bytes cleared
+void KeyCounterBaseWords(const uint8_t base[33], const KeyCounterLayout& layout, uint32_t words[9]);
+
+// Fixed-prefix descriptor for the keys of a base and layout: the message
+// words without counter bytes are shared by all keys, so the rounds before
+// the first counter byte's word run once here. Used by
+// KeyCounterPrefixHashBatch and PTX kernels generated with --input-mode prefix.
+void KeyCounterPrefixInit(const uint8_t base[33], const KeyCounterLayout& layout, SHA256Prefix& prefix);
+
+// Bit i set if message word i of a key holds a counter byte
+uint32_t KeyCounterVaryingWords(const KeyCounterLayout& layout);
+
+// Same digests as KeyCounterHashBatch, computed lane-parallel from a prefix
+// made by KeyCounterPrefixInit with the same layout
+void KeyCounterPrefixHashBatch(const SHA256Prefix& prefix, const KeyCounterLayout& layout,
+                               uint64_t start, uint8_t* hashes, size_t count);
+
+#endif // KEY_COUNTER_H
@@ -0,0 +1,70 @@
+/*
+ * Bitcoin Merkle roots for HASH256_PTX
+ *
+ * Builds the transaction Merkle tree level by level: every level is one
+ * batched SHA256d over 64-byte child pairs (SHA256dNode64Batch), split
+ * across worker threads when it is large. A level with an odd number of
+ * nodes pairs its last node with itself, as Bitcoin does. Hashes are in
+ * internal byte order (as hashed, not the reversed display form).
+ *
+ * MerkleTree keeps every level of the same tree, so appending or replacing
+ * leaves only rehashes their ancestors: O(log n) node hashes per leaf, with
+ * the dirty nodes of one level hashed as a single batch.
+ */
+
+#ifndef MERKLE_H
+#define MERKLE_H
+
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+
+// Number of levels above the leaves for count leaves (0 for 0 or 1 leaf),
+// i.e. the length of an authentication path
+size_t MerkleDepth(size_t count);
+
+// Root of count txids of 32 bytes each, stored back to back. An empty list
+// gives an all-zero root and a single txid is its own root. If path is not
+// null it receives MerkleDepth(count) 32-byte sibling hashes for leaf
+// (< count; bottom level first). num_threads 0 uses every hardware thread.
+void MerkleRoot(const uint8_t* txids, size_t count, uint8_t root[32],
+                size_t leaf = 0, uint8_t* path = NULL, unsigned num_threads = 0);
+
+// Fold an authentication path: the root of the tree in which hash sits at
+// index, given its depth siblings. Equals MerkleRoot's root for a valid path.
+void MerkleRootFromPath(const uint8_t hash[32], size_t index, const uint8_t* path, size_t depth,
+                        uint8_t root[32]);
+
+// Persistent tree with the same shape and root as MerkleRoot. Levels are
+// stored bottom-up, each one contiguous array of nodes in word layout.
+class MerkleTree {
+public:
+    MerkleTree();
+
+    void Clear();
+    size_t Size() const { return levels[0].size() / 8; }
+
+    // Add leaves at the end and rehash the nodes above them
+    void Append(const uint8_t leaf[32]);
+    void AppendBatch(const uint8_t* leaves, size_t count);
+
+    // Replace leaf index (< Size()). A batch rehashes each shared ancestor
+    // once; if an index repeats, its last leaf wins.
+    void Update(size_t index, const uint8_t leaf[32]);
+    void UpdateBatch(const size_t* indices, const uint8_t* leaves, size_t count);
+
+    // Root of the current leaves (all zero when empty)
+    void Root(uint8_t root[32]) const;
+
+    // MerkleDepth(Size()) sibling hashes for leaf index, as MerkleRoot gives
+    void Path(size_t index, uint8_t* path) const;
+
+private:
+    // Rehash the ancestors of the sorted leaf indices in dirty
+    void Rehash(std::vector<size_t>& dirty);
+
+    std::vector<std::vector<uint32_t> > levels;
+    std::vector<uint32_t> scratch;
+};
+
+#endif // MERKLE_H
@@ -0,0 +1,36 @@
+/*
+ * PBKDF2-HMAC-SHA256 for HASH256_PTX
+ *
+ * Each 32-byte output block T_i is U_1 ^ ... ^ U_c with U_1 =
+ * HMAC(P, S || INT(i)) and U_j = HMAC(P, U_{j-1}). After U_1 every
+ * iteration is two compressions of a 32-byte digest plus fixed padding,
+ * one from the password's inner-pad midstate and one from its outer-pad
+ * midstate. The batch computes those midstates once per job, keeps the
+ * padding's schedule terms in one shared SHA256Prefix, and runs
+ * SHA256_LANES output blocks (of any jobs) side by side on each thread.
+ */
+
+#ifndef PBKDF2_H
+#define PBKDF2_H
+
+#include <stdint.h>
+#include <string.h>
+
+struct PBKDF2Job {
+    const uint8_t* password;
+    size_t password_len;
+    const uint8_t* salt;
+    size_t salt_len;
+    uint8_t* key;                 // receives key_len bytes
+    size_t key_len;
+};
+
+// Single derivation of key_len bytes with iterations >= 1
+void PBKDF2HMACSHA256(const uint8_t* password, size_t password_len, const uint8_t* salt, size_t salt_len,
+                      uint32_t iterations, uint8_t* key, size_t key_len);
+
+// count independent derivations with the same iteration count. num_threads
+// 0 uses every hardware thread.
+void PBKDF2HMACSHA256Batch(const PBKDF2Job* jobs, size_t count, uint32_t iterations, unsigned num_threads = 0);
+
+#endif // PBKDF2_H
@@ -7,10 +7,34 @@
 #include <sstream>
 #include <iostream>
 #include <stdexcept>
+#include <vector>
+#include "key_counter.h"
+#include "sha256_arena.h"
+#include "target_filter.h"
+
+// Kernel shapes reported by the generator through sha256_kernel_info.
+// Keep in sync with INPUT_MODES / OUTPUT_MODES in generate_sha256_ptx.py.
+enum PTXInputMode : uint32_t {
+    PTX_INPUT_KEYS33 = 0,    // 33 bytes per key, read from param_input
+    PTX_INPUT_COUNTER = 1,   // keys built on the device from a base + counter
+    PTX_INPUT_PREFIX = 2,    // counter keys from a host-precomputed SHA256Prefix
+    PTX_INPUT_NODE64 = 3,    // 64-byte Merkle nodes: two child digests as native words
+    PTX_INPUT_ARENA = 4      // variable-length messages from a packed SHA256Arena
+};
+
+enum PTXOutputMode : uint32_t {
+    PTX_OUTPUT_BYTES = 0,    // 32 big-endian digest bytes per key
+    PTX_OUTPUT_WORDS = 1,    // 8 native-endian uint32_t digest words per key
+    PTX_OUTPUT_FILTER = 2,   // indices of keys passing the target filter
+    PTX_OUTPUT_MATCH = 3     // TargetHit records, non-candidates stop at round 60
+};
 
 class PTX_SHA256 {
 public:
-    PTX_SHA256() : module_(nullptr), kernel_(nullptr), initialized_(false) {}
+    PTX_SHA256() : module_(nullptr), kernel_(nullptr), context_(nullptr), initialized_(false),
+                   input_mode_(PTX_INPUT_KEYS33), output_mode_(PTX_OUTPUT_BYTES), counter_layout_(),
+                   ilp_(1), grid_stride_(false), resident_blocks_(0), num_registers_(0),
+                   d_filter_(0), filter_mask_(0), filter_key_(TARGET_FILTER_KEY_H0H1) {}
     
     ~PTX_SHA256() {
         cleanup();
@@ -52,6 +76,8 @@ public:
                 return false;
             }
             
+            read_kernel_info();
+            
             initialized_ = true;
             return true;
             
@@ -63,50 +89,265 @@ public:
     
     // Hash multiple public keys
     bool hash_batch(const uint8_t* h_input, uint8_t* h_output, uint32_t num_keys) {
+        if (!check_kernel(PTX_INPUT_KEYS33, PTX_OUTPUT_BYTES, "hash_batch")) {
+            return false;
+        }
+        return run_input(h_input, 33, digest_output(h_output), num_keys);
+    }
+    
+    // Hash multiple public keys into native-endian digest words (8 per key).
+    // Requires a kernel generated with --output-layout words.
+    bool hash_batch_words(const uint8_t* h_input, uint32_t* h_output, uint32_t num_keys) {
+        if (!check_kernel(PTX_INPUT_KEYS33, PTX_OUTPUT_WORDS, "hash_batch_words")) {
+            return false;
+        }
+        return run_input(h_input, 33, digest_output(h_output), num_keys);
+    }
+    
+    // Hash num_nodes 64-byte Merkle nodes, each two child digests as 16
+    // native-endian words (see sha256_node.h), into 8 parent digest words per
+    // node. Requires a kernel generated with --input-mode node64 --output-layout words.
+    bool hash_node64_batch_words(const uint32_t* h_children, uint32_t* h_parents, uint32_t num_nodes) {
+        if (!check_kernel(PTX_INPUT_NODE64, PTX_OUTPUT_WORDS, "hash_node64_batch_words")) {
+            return false;
+        }
+        return run_input(h_children, 64, digest_output(h_parents), num_nodes);
+    }
+    
+    // Same, producing digest bytes (--input-mode node64 with the default layout)
+    bool hash_node64_batch(const uint32_t* h_children, uint8_t* h_output, uint32_t num_nodes) {
+        if (!check_kernel(PTX_INPUT_NODE64, PTX_OUTPUT_BYTES, "hash_node64_batch")) {
+            return false;
+        }
+        return run_input(h_children, 64, digest_output(h_output), num_nodes);
+    }
+    
+    // Hash every message of a packed arena (see sha256_arena.h); digest i
+    // lands at h_output + i * 32, in the order the messages were packed from.
+    // Requires a kernel generated with --input-mode arena.
+    bool hash_arena_batch(const SHA256Arena& arena, uint8_t* h_output) {
+        if (!check_kernel(PTX_INPUT_ARENA, PTX_OUTPUT_BYTES, "hash_arena_batch")) {
+            return false;
+        }
+        return run_arena(arena, digest_output(h_output));
+    }
+    
+    // Same, into 8 native-endian words per message (--output-layout words)
+    bool hash_arena_batch_words(const SHA256Arena& arena, uint32_t* h_output) {
+        if (!check_kernel(PTX_INPUT_ARENA, PTX_OUTPUT_WORDS, "hash_arena_batch_words")) {
+            return false;
+        }
+        return run_arena(arena, digest_output(h_output));
+    }
+    
+    // Hash keys start .. start + num_keys - 1 enumerated on the device from a
+    // 33-byte base key (see key_counter.h). Only the key counter travels to
+    // the GPU. Requires a kernel generated with --input-mode counter whose
+    // --counter-positions match layout.
+    bool hash_counter_batch(const uint8_t base[33], const KeyCounterLayout& layout, uint64_t start,
+                            uint8_t* h_output, uint32_t num_keys) {
+        if (!check_kernel(PTX_INPUT_COUNTER, PTX_OUTPUT_BYTES, "hash_counter_batch") ||
+            !check_counter_layout(layout)) {
+            return false;
+        }
+        return run_counter(base, layout, start, digest_output(h_output), num_keys);
+    }
+    
+    // Same, producing native-endian digest words (--output-layout words)
+    bool hash_counter_batch_words(const uint8_t base[33], const KeyCounterLayout& layout, uint64_t start,
+                                  uint32_t* h_output, uint32_t num_keys) {
+        if (!check_kernel(PTX_INPUT_COUNTER, PTX_OUTPUT_WORDS, "hash_counter_batch_words") ||
+            !check_counter_layout(layout)) {
+            return false;
+        }
+        return run_counter(base, layout, start, digest_output(h_output), num_keys);
+    }
+    
+    // Hash the same keys as hash_counter_batch from a fixed-prefix descriptor
+    // made by KeyCounterPrefixInit: the rounds before the first counter byte
+    // and the fixed schedule terms are computed once on the host and passed
+    // as a kernel parameter. Requires a kernel generated with --input-mode
+    // prefix whose --counter-positions match layout.
+    bool hash_prefix_batch(const SHA256Prefix& prefix, const KeyCounterLayout& layout, uint64_t start,
+                           uint8_t* h_output, uint32_t num_keys) {
+        if (!check_kernel(PTX_INPUT_PREFIX, PTX_OUTPUT_BYTES, "hash_prefix_batch") ||
+            !check_counter_layout(layout) || !check_prefix(prefix)) {
+            return false;
+        }
+        return run_prefix(prefix, start, digest_output(h_output), num_keys);
+    }
+    
+    // Same, producing native-endian digest words (--output-layout words)
+    bool hash_prefix_batch_words(const SHA256Prefix& prefix, const KeyCounterLayout& layout, uint64_t start,
+                                 uint32_t* h_output, uint32_t num_keys) {
+        if (!check_kernel(PTX_INPUT_PREFIX, PTX_OUTPUT_WORDS, "hash_prefix_batch_words") ||
+            !check_counter_layout(layout) || !check_prefix(prefix)) {
+            return false;
+        }
+        return run_prefix(prefix, start, digest_output(h_output), num_keys);
+    }
+    
+    // Upload the target filter probed by --output-layout filter (H0/H1 key)
+    // or match (H7/H3 key) kernels. Stays on the device until replaced.
+    bool load_filter(const TargetFilter& filter) {
         if (!initialized_) {
             std::cerr << "PTX_SHA256 not initialized" << std::endl;
             return false;
         }
-        
-        // Allocate device memory
-        CUdeviceptr d_input, d_output;
-        size_t input_size = num_keys * 33;   // 33 bytes per compressed pubkey
-        size_t output_size = num_keys * 32;  // 32 bytes per SHA256 hash
-        
-        CUresult result = cuMemAlloc(&d_input, input_size);
+        CUresult result = cuCtxSetCurrent(context_);
         if (result != CUDA_SUCCESS) {
-            std::cerr << "Failed to allocate input memory" << std::endl;
+            std::cerr << "Failed to set CUDA context" << std::endl;
             return false;
         }
-        
-        result = cuMemAlloc(&d_output, output_size);
+        free_filter();
+        result = cuMemAlloc(&d_filter_, filter.SizeBytes());
         if (result != CUDA_SUCCESS) {
-            cuMemFree(d_input);
-            std::cerr << "Failed to allocate output memory" << std::endl;
+            d_filter_ = 0;
+            std::cerr << "Failed to allocate filter memory" << std::endl;
             return false;
         }
-        
-        // Copy input to device
-        result = cuMemcpyHtoD(d_input, h_input, input_size);
+        result = cuMemcpyHtoD(d_filter_, filter.Data(), filter.SizeBytes());
         if (result != CUDA_SUCCESS) {
-            cuMemFree(d_input);
-            cuMemFree(d_output);
-            std::cerr << "Failed to copy input to device" << std::endl;
+            free_filter();
+            std::cerr << "Failed to copy filter to device" << std::endl;
             return false;
         }
+        filter_mask_ = filter.BlockMask();
+        filter_key_ = filter.Key();
+        return true;
+    }
+    
+    // Hash public keys and keep only the indices of those whose digest passes
+    // the loaded filter (hit-list format in target_filter.h). *num_hits is
+    // the total number of hits; only the first max_hits are stored.
+    bool hash_batch_filter(const uint8_t* h_input, uint32_t* hits, uint32_t max_hits,
+                           uint32_t num_keys, uint32_t* num_hits) {
+        if (!check_kernel(PTX_INPUT_KEYS33, PTX_OUTPUT_FILTER, "hash_batch_filter") || !check_filter()) {
+            return false;
+        }
+        return run_input(h_input, 33, filter_output(hits, max_hits, num_hits), num_keys);
+    }
+    
+    // Match mode: like hash_batch_filter, but the filter (keyed on H7/H3) is
+    // tested after round 60 so non-candidates skip the last rounds, and each
+    // hit comes back as a TargetHit with its digest words
+    bool hash_batch_match(const uint8_t* h_input, TargetHit* hits, uint32_t max_hits,
+                          uint32_t num_keys, uint32_t* num_hits) {
+        if (!check_kernel(PTX_INPUT_KEYS33, PTX_OUTPUT_MATCH, "hash_batch_match") || !check_filter()) {
+            return false;
+        }
+        return run_input(h_input, 33, filter_output(hits, max_hits, num_hits), num_keys);
+    }
+    
+    // Counter-mode filter batch: hit index i means key start + i
+    bool hash_counter_batch_filter(const uint8_t base[33], const KeyCounterLayout& layout, uint64_t start,
+                                   uint32_t* hits, uint32_t max_hits, uint32_t num_keys, uint32_t* num_hits) {
+        if (!check_kernel(PTX_INPUT_COUNTER, PTX_OUTPUT_FILTER, "hash_counter_batch_filter") ||
+            !check_counter_layout(layout) || !check_filter()) {
+            return false;
+        }
+        return run_counter(base, layout, start, filter_output(hits, max_hits, num_hits), num_keys);
+    }
+    
+    // Counter-mode match batch: hit index i means key start + i
+    bool hash_counter_batch_match(const uint8_t base[33], const KeyCounterLayout& layout, uint64_t start,
+                                  TargetHit* hits, uint32_t max_hits, uint32_t num_keys, uint32_t* num_hits) {
+        if (!check_kernel(PTX_INPUT_COUNTER, PTX_OUTPUT_MATCH, "hash_counter_batch_match") ||
+            !check_counter_layout(layout) || !check_filter()) {
+            return false;
+        }
+        return run_counter(base, layout, start, filter_output(hits, max_hits, num_hits), num_keys);
+    }
+    
+    PTXInputMode input_mode() const { return input_mode_; }
+    PTXOutputMode output_mode() const { return output_mode_; }
+    
+    // Hashes interleaved per thread, whether the kernel loops over the batch,
+    // and the registers per thread the JIT allocated (compare variants with it)
+    uint32_t ilp() const { return ilp_; }
+    bool grid_stride() const { return grid_stride_; }
+    int num_registers() const { return num_registers_; }
+    
+private:
+    CUmodule module_;
+    CUfunction kernel_;
+    CUcontext context_;
+    bool initialized_;
+    PTXInputMode input_mode_;
+    PTXOutputMode output_mode_;
+    KeyCounterLayout counter_layout_;
+    uint32_t ilp_;
+    bool grid_stride_;
+    uint32_t resident_blocks_;
+    int num_registers_;
+    CUdeviceptr d_filter_;
+    uint32_t filter_mask_;
+    TargetFilterKey filter_key_;
+    
+    // Where a launch's results go: a digest buffer (num_keys * 32 bytes) or,
+    // for filter and match kernels, a hit list
+    struct KernelOutput {
+        void* digests;
+        void* hits;
+        uint32_t max_hits;
+        uint32_t* num_hits;
+    };
+    
+    static KernelOutput digest_output(void* digests) {
+        KernelOutput out = {digests, nullptr, 0, nullptr};
+        return out;
+    }
+    
+    static KernelOutput filter_output(void* hits, uint32_t max_hits, uint32_t* num_hits) {
+        KernelOutput out = {nullptr, hits, max_hits, num_hits};
+        return out;
+    }
+    
+    bool check_filter() {
+        if (!d_filter_) {
+            std::cerr << "No target filter loaded" << std::endl;
+            return false;
+        }
+        TargetFilterKey key = output_mode_ == PTX_OUTPUT_MATCH ? TARGET_FILTER_KEY_H7H3 : TARGET_FILTER_KEY_H0H1;
+        if (filter_key_ != key) {
+            std::cerr << "Target filter is keyed on the wrong digest words for this kernel" << std::endl;
+            return false;
+        }
+        return true;
+    }
+    
+    void free_filter() {
+        if (d_filter_) {
+            cuMemFree(d_filter_);
+            d_filter_ = 0;
+        }
+    }
+    
+    bool check_kernel(PTXInputMode input_mode, PTXOutputMode output_mode, const char* caller) {
+        if (!initialized_) {
+            std::cerr << "PTX_SHA256 not initialized" << std::endl;
+            return false;
+        }
+        if (input_mode_ != input_mode || output_mode_ != output_mode) {
+            std::cerr << caller << ": loaded kernel has input mode " << input_mode_
+                      << ", output mode " << output_mode_ << std::endl;
+            return false;
+        }
+        return true;
+    }
+    
+    // One thread per key, or for grid-stride kernels at most as many blocks
+    // as can be resident at once (each thread loops over ilp keys per pass)
+    CUresult launch(void** args, uint32_t num_keys) {
+        // Smaller block size for better occupancy with the kernel's register use
+        const uint32_t threads_per_block = 128;
+        uint32_t keys_per_block = threads_per_block * (grid_stride_ ? ilp_ : 1);
+        uint32_t blocks = (num_keys + keys_per_block - 1) / keys_per_block;
+        if (grid_stride_ && blocks > resident_blocks_) {
+            blocks = resident_blocks_;
+        }
         
-        // Set kernel parameters
-        void* args[] = {
-            &d_input,
-            &d_output,
-            &num_keys
-        };
-        
-        // Launch kernel - using smaller block size for better occupancy
-        int threads_per_block = 128;  // Reduced from 256 for better occupancy with 40 registers
-        int blocks = (num_keys + threads_per_block - 1) / threads_per_block;
-        
-        result = cuLaunchKernel(
+        return cuLaunchKernel(
             kernel_,
             blocks, 1, 1,                    // grid dimensions
             threads_per_block, 1, 1,         // block dimensions
@@ -115,44 +356,256 @@ public:
             args,                             // kernel arguments
             nullptr                           // extra
         );
-        
+    }
+    
+    // Copy fixed-size input records (33-byte keys, 64-byte nodes) in and run the kernel
+    bool run_input(const void* h_input, size_t record_size, const KernelOutput& out, uint32_t num_keys) {
+        // Each instance owns its context; make it current in case several
+        // kernels are loaded side by side
+        CUresult result = cuCtxSetCurrent(context_);
         if (result != CUDA_SUCCESS) {
-            cuMemFree(d_input);
-            cuMemFree(d_output);
-            std::cerr << "Failed to launch kernel" << std::endl;
+            std::cerr << "Failed to set CUDA context" << std::endl;
             return false;
         }
         
-        // Wait for completion
-        result = cuCtxSynchronize();
+        // Allocate device memory
+        CUdeviceptr d_input;
+        size_t input_size = (size_t)num_keys * record_size;
+        
+        result = cuMemAlloc(&d_input, input_size);
         if (result != CUDA_SUCCESS) {
-            cuMemFree(d_input);
-            cuMemFree(d_output);
-            std::cerr << "Kernel execution failed" << std::endl;
+            std::cerr << "Failed to allocate input memory" << std::endl;
             return false;
         }
         
-        // Copy output back to host
-        result = cuMemcpyDtoH(h_output, d_output, output_size);
+        // Copy input to device
+        result = cuMemcpyHtoD(d_input, h_input, input_size);
         if (result != CUDA_SUCCESS) {
             cuMemFree(d_input);
-            cuMemFree(d_output);
-            std::cerr << "Failed to copy output from device" << std::endl;
+            std::cerr << "Failed to copy input to device" << std::endl;
             return false;
         }
         
-        // Free device memory
+        void* input_args[] = { &d_input };
+        bool ok = run(input_args, 1, out, num_keys);
+        
         cuMemFree(d_input);
-        cuMemFree(d_output);
+        return ok;
+    }
+    
+    // Copy the arena bytes and the entry table in; one thread per entry
+    bool run_arena(const SHA256Arena& arena, const KernelOutput& out) {
+        CUresult result = cuCtxSetCurrent(context_);
+        if (result != CUDA_SUCCESS) {
+            std::cerr << "Failed to set CUDA context" << std::endl;
+            return false;
+        }
+        uint32_t num_keys = (uint32_t)arena.entries.size();
+        if (num_keys == 0) {
+            return true;
+        }
         
+        CUdeviceptr d_arena = 0, d_entries = 0;
+        size_t arena_size = arena.bytes.size() ? arena.bytes.size() : 1;
+        size_t entries_size = arena.entries.size() * sizeof(SHA256ArenaEntry);
+        result = cuMemAlloc(&d_arena, arena_size);
+        if (result == CUDA_SUCCESS) {
+            result = cuMemAlloc(&d_entries, entries_size);
+        }
+        if (result == CUDA_SUCCESS && !arena.bytes.empty()) {
+            result = cuMemcpyHtoD(d_arena, arena.bytes.data(), arena.bytes.size());
+        }
+        if (result == CUDA_SUCCESS) {
+            result = cuMemcpyHtoD(d_entries, arena.entries.data(), entries_size);
+        }
+        bool ok = false;
+        if (result != CUDA_SUCCESS) {
+            std::cerr << "Failed to copy the arena to the device" << std::endl;
+        } else {
+            void* input_args[] = { &d_arena, &d_entries };
+            ok = run(input_args, 2, out, num_keys);
+        }
+        
+        if (d_entries) {
+            cuMemFree(d_entries);
+        }
+        if (d_arena) {
+            cuMemFree(d_arena);
+        }
+        return ok;
+    }
+    
+    // The counter positions are compiled into the kernel; refuse a mismatch
+    // rather than silently hashing different keys
+    bool check_counter_layout(const KeyCounterLayout& layout) {
+        if (!KeyCounterLayoutValid(layout)) {
+            std::cerr << "Invalid key counter layout" << std::endl;
+            return false;
+        }
+        if (!KeyCounterLayoutEqual(layout, counter_layout_)) {
+            std::cerr << "Key counter layout does not match the loaded kernel" << std::endl;
+            return false;
+        }
         return true;
     }
     
-private:
-    CUmodule module_;
-    CUfunction kernel_;
-    CUcontext context_;
-    bool initialized_;
+    // Launch the counter kernel: no input buffer, the base key and counter
+    // start are passed as kernel parameters
+    bool run_counter(const uint8_t base[33], const KeyCounterLayout& layout, uint64_t start,
+                     const KernelOutput& out, uint32_t num_keys) {
+        CUresult result = cuCtxSetCurrent(context_);
+        if (result != CUDA_SUCCESS) {
+            std::cerr << "Failed to set CUDA context" << std::endl;
+            return false;
+        }
+        
+        uint32_t base_words[9];
+        KeyCounterBaseWords(base, layout, base_words);
+        
+        void* input_args[] = { base_words, &start };
+        return run(input_args, 2, out, num_keys);
+    }
+    
+    // The kernel's round split is fixed by its counter positions; the
+    // descriptor must have been built for the same words
+    bool check_prefix(const SHA256Prefix& prefix) {
+        uint32_t varying_words = KeyCounterVaryingWords(counter_layout_);
+        if (prefix.varying_words != varying_words || prefix.varying != SHA256PrefixVarying(varying_words)) {
+            std::cerr << "Prefix descriptor does not match the loaded kernel's counter layout" << std::endl;
+            return false;
+        }
+        return true;
+    }
+    
+    // Launch the prefix kernel: the descriptor's state and schedule table
+    // travel as one parameter, followed by the counter start
+    bool run_prefix(const SHA256Prefix& prefix, uint64_t start, const KernelOutput& out, uint32_t num_keys) {
+        CUresult result = cuCtxSetCurrent(context_);
+        if (result != CUDA_SUCCESS) {
+            std::cerr << "Failed to set CUDA context" << std::endl;
+            return false;
+        }
+        
+        uint32_t prefix_param[8 + 64];
+        memcpy(prefix_param, prefix.state, sizeof(prefix.state));
+        memcpy(prefix_param + 8, prefix.schedule, sizeof(prefix.schedule));
+        
+        void* input_args[] = { prefix_param, &start };
+        return run(input_args, 2, out, num_keys);
+    }
+    
+    // Allocate the outputs, append their parameters to the input ones, run
+    // the kernel and copy the results back
+    bool run(void* const* input_args, size_t num_input_args, const KernelOutput& out, uint32_t num_keys) {
+        bool filter = output_mode_ == PTX_OUTPUT_FILTER || output_mode_ == PTX_OUTPUT_MATCH;
+        size_t record_size = output_mode_ == PTX_OUTPUT_MATCH ? sizeof(TargetHit) : sizeof(uint32_t);
+        size_t output_size = filter ? (out.max_hits ? out.max_hits : 1) * record_size
+                                    : (size_t)num_keys * 32;
+        CUdeviceptr d_output, d_hit_count = 0;
+        
+        CUresult result = cuMemAlloc(&d_output, output_size);
+        if (result != CUDA_SUCCESS) {
+            std::cerr << "Failed to allocate output memory" << std::endl;
+            return false;
+        }
+        if (filter) {
+            result = cuMemAlloc(&d_hit_count, sizeof(uint32_t));
+            if (result == CUDA_SUCCESS) {
+                result = cuMemsetD32(d_hit_count, 0, 1);
+            }
+            if (result != CUDA_SUCCESS) {
+                if (d_hit_count) {
+                    cuMemFree(d_hit_count);
+                }
+                cuMemFree(d_output);
+                std::cerr << "Failed to allocate hit counter" << std::endl;
+                return false;
+            }
+        }
+        
+        std::vector<void*> args(input_args, input_args + num_input_args);
+        uint32_t max_hits = out.max_hits;
+        if (filter) {
+            args.push_back(&d_filter_);
+            args.push_back(&filter_mask_);
+            args.push_back(&d_output);
+            args.push_back(&d_hit_count);
+            args.push_back(&max_hits);
+        } else {
+            args.push_back(&d_output);
+        }
+        args.push_back(&num_keys);
+        
+        bool ok = false;
+        if (launch(&args[0], num_keys) != CUDA_SUCCESS) {
+            std::cerr << "Failed to launch kernel" << std::endl;
+        } else if (cuCtxSynchronize() != CUDA_SUCCESS) {
+            std::cerr << "Kernel execution failed" << std::endl;
+        } else {
+            if (!filter) {
+                ok = cuMemcpyDtoH(out.digests, d_output, output_size) == CUDA_SUCCESS;
+            } else {
+                // Only the stored part of the hit list comes back
+                uint32_t num_hits = 0;
+                ok = cuMemcpyDtoH(&num_hits, d_hit_count, sizeof(uint32_t)) == CUDA_SUCCESS;
+                uint32_t stored = num_hits < max_hits ? num_hits : max_hits;
+                if (ok && stored) {
+                    ok = cuMemcpyDtoH(out.hits, d_output, stored * record_size) == CUDA_SUCCESS;
+                }
+                *out.num_hits = num_hits;
+            }
+            if (!ok) {
+                std::cerr << "Failed to copy output from device" << std::endl;
+            }
+        }
+        
+        cuMemFree(d_output);
+        if (d_hit_count) {
+            cuMemFree(d_hit_count);
+        }
+        return ok;
+    }
+    
+    // Read the {input mode, output mode, ilp, grid-stride} shape exported by
+    // the generator. Kernels generated before the shape table existed are
+    // plain keys33/bytes with one key per thread; the ilp and grid-stride
+    // words were added later and default to 1 and 0.
+    void read_kernel_info() {
+        cuFuncGetAttribute(&num_registers_, CU_FUNC_ATTRIBUTE_NUM_REGS, kernel_);
+        
+        CUdeviceptr info_ptr;
+        size_t info_size;
+        if (cuModuleGetGlobal(&info_ptr, &info_size, module_, "sha256_kernel_info") != CUDA_SUCCESS) {
+            return;
+        }
+        uint32_t info[4] = {PTX_INPUT_KEYS33, PTX_OUTPUT_BYTES, 1, 0};
+        if (info_size > sizeof(info)) {
+            info_size = sizeof(info);
+        }
+        if (cuMemcpyDtoH(info, info_ptr, info_size) == CUDA_SUCCESS) {
+            input_mode_ = (PTXInputMode)info[0];
+            output_mode_ = (PTXOutputMode)info[1];
+            ilp_ = info[2] ? info[2] : 1;
+            grid_stride_ = info[3] != 0;
+        }
+        
+        // Grid-stride kernels launch one full wave of resident blocks
+        if (grid_stride_) {
+            CUdevice device;
+            int sm_count = 1, blocks_per_sm = 1;
+            cuCtxGetDevice(&device);
+            cuDeviceGetAttribute(&sm_count, CU_DEVICE_ATTRIBUTE_MULTIPROCESSOR_COUNT, device);
+            cuOccupancyMaxActiveBlocksPerMultiprocessor(&blocks_per_sm, kernel_, 128, 0);
+            resident_blocks_ = (uint32_t)(sm_count * (blocks_per_sm > 0 ? blocks_per_sm : 1));
+        }
+        
+        // Counter and prefix kernels also export {num_bytes, positions[8]}
+        if ((input_mode_ == PTX_INPUT_COUNTER || input_mode_ == PTX_INPUT_PREFIX) &&
+            cuModuleGetGlobal(&info_ptr, &info_size, module_, "sha256_counter_layout") == CUDA_SUCCESS &&
+            info_size == sizeof(KeyCounterLayout)) {
+            cuMemcpyDtoH(&counter_layout_, info_ptr, sizeof(KeyCounterLayout));
+        }
+    }
     
     std::string read_ptx(const std::string& ptx_file_path) {
         std::ifstream file(ptx_file_path);
@@ -253,6 +706,10 @@ private:
     }
     
     void cleanup() {
+        if (context_) {
+            cuCtxSetCurrent(context_);
+        }
+        free_filter();
         if (kernel_) {
             kernel_ = nullptr;
         }
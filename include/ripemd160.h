@@ -0,0 +1,42 @@
+/*
+ * RIPEMD-160 implementation for HASH256_PTX
+ * Based on the RIPEMD-160 specification (Dobbertin, Bosselaers, Preneel)
+ */
+
+#ifndef RIPEMD160_H
+#define RIPEMD160_H
+
+#include <stdint.h>
+#include <string.h>
+
+#define RIPEMD160_LANES 8
+
+class RIPEMD160 {
+public:
+    RIPEMD160();
+    void Init();
+    void Update(const uint8_t* data, size_t len);
+    void Final(uint8_t* hash);
+
+    // Convenience function for single-shot hashing
+    static void Hash(const uint8_t* data, size_t len, uint8_t* hash);
+
+private:
+    void Transform(const uint8_t* data);
+
+    uint32_t state[5];
+    uint64_t count;
+    uint8_t buffer[64];
+};
+
+// Initial RIPEMD-160 state
+extern const uint32_t RIPEMD160_IV[5];
+
+// Compress one block given as little-endian message words
+void RIPEMD160TransformWords(uint32_t state[5], const uint32_t x[16]);
+
+// One compression per lane: state[i][lane] and x[i][lane] hold word i of
+// that lane's state and (little-endian) message block
+void RIPEMD160TransformLanes(uint32_t state[5][RIPEMD160_LANES], const uint32_t x[16][RIPEMD160_LANES]);
+
+#endif // RIPEMD160_H
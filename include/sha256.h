@@ -9,22 +9,86 @@
 #include <stdint.h>
 #include <string.h>
 
+// Saved hashing state (SHA256::Save), version 1, 112 bytes:
+//   0..3     magic "S256"
+//   4        format version
+//   5        buffered tail bytes (count % 64)
+//   6..7     zero
+//   8..15    count, big-endian
+//   16..47   state words, big-endian
+//   48..111  buffered tail, zero-filled past its end
+// The layout only changes with the version, so a state saved on one
+// machine resumes on any other.
+#define SHA256_SAVED_VERSION 1
+#define SHA256_SAVED_BYTES 112
+
+// One piece of a scatter-gather message, as in struct iovec
+struct SHA256Fragment {
+    const uint8_t* data;
+    size_t len;
+};
+
 class SHA256 {
 public:
     SHA256();
     void Init();
     void Update(const uint8_t* data, size_t len);
+    
+    // Update with the concatenation of num fragments. A block that spans
+    // fragments is assembled in the buffer; whole blocks inside a fragment
+    // are compressed from the caller's memory.
+    void UpdateV(const SHA256Fragment* fragments, size_t num);
+    
     void Final(uint8_t* hash);
     
+    // Finalize into native-endian state words; word i holds digest bytes
+    // 4i..4i+3 as a big-endian value (see sha256_digest.h)
+    void FinalWords(uint32_t hash[8]);
+    
+    // Chaining value after the whole blocks consumed so far. Once a multiple
+    // of 64 bytes has been hashed this is the midstate shared by every
+    // message with that prefix.
+    void Midstate(uint32_t out[8]) const;
+    
+    // Resume from a Midstate() taken after len bytes (a multiple of 64), as
+    // if those bytes had just been passed to Update()
+    void SetMidstate(const uint32_t in[8], uint64_t len);
+    
+    // Checkpoint everything hashed so far, for Restore here or elsewhere
+    void Save(uint8_t out[SHA256_SAVED_BYTES]) const;
+    
+    // Resume from a Save(). Returns false, leaving this object unchanged,
+    // for a wrong magic or version, an inconsistent tail or non-zero fill.
+    bool Restore(const uint8_t in[SHA256_SAVED_BYTES]);
+    
     // Convenience function for single-shot hashing
     static void Hash(const uint8_t* data, size_t len, uint8_t* hash);
     
 private:
     void Transform(const uint8_t* data);
+    void Pad();
     
     uint32_t state[8];
     uint64_t count;
     uint8_t buffer[64];
 };
 
+// SHA-224 initial hash value (FIPS 180-4), defined in sha256.cpp
+extern const uint32_t SHA224_IV[8];
+
+// SHA-224: SHA256 from its own IV, truncated to 28 bytes. For lanes, pass
+// SHA224_IV as init to SHA256HashLanes and keep words 0..6.
+class SHA224 {
+public:
+    SHA224();
+    void Init();
+    void Update(const uint8_t* data, size_t len);
+    void Final(uint8_t* hash);
+    
+    static void Hash(const uint8_t* data, size_t len, uint8_t* hash);
+    
+private:
+    SHA256 sha;
+};
+
 #endif // SHA256_H
@@ -0,0 +1,58 @@
+/*
+ * Packed variable-length batches for HASH256_PTX
+ *
+ * Kernels generated with --input-mode arena hash messages of any length, one
+ * per thread. The bytes of all messages sit back to back in one arena, and
+ * an entry table gives each thread its message's offset and length and the
+ * slot its digest goes to. Each thread pads its own message and loops over
+ * its blocks.
+ *
+ * Threads of a warp run that loop in lockstep, so a warp costs as much as
+ * its longest message. The packer therefore stable-sorts the messages by
+ * block count before laying them out: a warp only mixes two counts at a
+ * boundary between buckets. Digests still come out in the caller's order,
+ * through each entry's index.
+ *
+ * SHA256ArenaHash walks a packed arena on the CPU the same way, so the
+ * packing can be checked without a GPU.
+ */
+
+#ifndef SHA256_ARENA_H
+#define SHA256_ARENA_H
+
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+
+// Longest message an entry can describe: the kernel counts blocks and
+// positions in 32 bits
+#define SHA256_ARENA_MAX_MESSAGE (0xffffffffu - 127)
+
+// One message of a packed batch, as the kernel reads it (16 bytes).
+// Keep in sync with ARENA_ENTRY_BYTES in generate_sha256_ptx.py.
+struct SHA256ArenaEntry {
+    uint64_t offset;     // first message byte in the arena
+    uint32_t length;     // message bytes
+    uint32_t index;      // caller's message number: digest slot
+};
+
+struct SHA256Arena {
+    std::vector<uint8_t> bytes;
+    std::vector<SHA256ArenaEntry> entries;     // ascending block count
+};
+
+// Compression blocks of a len-byte message, padding included
+static inline uint64_t SHA256BlockCount(uint64_t len) {
+    return (len + 9 + 63) / 64;
+}
+
+// Pack count messages (msgs[i], lens[i] bytes) into arena, sorted by block
+// count; messages with the same count keep their order. Fails if a message
+// is longer than SHA256_ARENA_MAX_MESSAGE or count does not fit an index.
+bool SHA256ArenaPack(SHA256Arena& arena, const uint8_t* const* msgs, const size_t* lens, size_t count);
+
+// Hash every entry of a packed arena, as the arena kernel does: 32 digest
+// bytes per message at hashes + index * 32
+void SHA256ArenaHash(const SHA256Arena& arena, uint8_t* hashes);
+
+#endif // SHA256_ARENA_H
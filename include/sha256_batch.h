@@ -0,0 +1,84 @@
+/*
+ * Mixed-length SHA256 batches for HASH256_PTX
+ *
+ * The lane engine (sha256_lanes.h) compresses SHA256_LANES blocks at once,
+ * but messages of different lengths need different numbers of blocks. If
+ * lanes are filled in arrival order and a group runs until its longest
+ * message ends, every shorter lane sits idle for the difference; with a
+ * long-tailed length distribution that is most of the vector.
+ *
+ * SHA256HashBatch schedules the batch instead. Messages are bucketed by
+ * block count, longest first, so lanes that start together tend to finish
+ * together. Each lane then works through a queue: as soon as its message's
+ * last block is compressed, the digest is written and the next message
+ * starts in that lane on the following compression. Lanes only idle once
+ * the queue is empty. Large batches are split across worker threads in
+ * contiguous shares of about equal block counts.
+ *
+ * SHA256JobManager runs the same lanes for callers whose messages arrive
+ * one at a time. Submit places a job in a free lane and only compresses
+ * once every lane is busy; jobs complete in whatever order their lengths
+ * dictate, each handed back by a later Submit or by Flush, which also
+ * drains partly filled lanes when no more jobs are coming.
+ */
+
+#ifndef SHA256_BATCH_H
+#define SHA256_BATCH_H
+
+#include <stdint.h>
+#include <string.h>
+#include "sha256_lanes.h"
+
+// SHA256 of count messages (msgs[i], lens[i] bytes) into 32 digest bytes
+// each at hashes + i * 32. num_threads 0 uses every hardware thread.
+void SHA256HashBatch(const uint8_t* const* msgs, const size_t* lens, size_t count, uint8_t* hashes,
+                     unsigned num_threads = 0);
+
+// Message in flight in one lane
+struct SHA256LaneJob {
+    const uint8_t* msg;
+    uint64_t len;
+    uint64_t pos;        // start of the next block
+    uint64_t end;        // padded length
+    uint8_t* hash;       // NULL while the lane is idle
+};
+
+// One hashing job. msg is referenced, not copied, and must stay valid until
+// the manager hands the job back with hash filled in.
+struct SHA256Job {
+    const uint8_t* msg;
+    size_t len;
+    uint8_t hash[32];
+    void* user_data;     // untouched by the manager
+};
+
+class SHA256JobManager {
+public:
+    SHA256JobManager();
+
+    // Start job. If that fills the last free lane, compress until at least
+    // one job completes. Returns a completed job, or NULL if none is ready.
+    SHA256Job* Submit(SHA256Job* job);
+
+    // Return a completed job, compressing the busy lanes (however few) until
+    // one completes; NULL once no job is left in flight
+    SHA256Job* Flush();
+
+    // Jobs submitted and not yet returned
+    size_t Pending() const { return busy + num_done; }
+
+private:
+    // Compress until at least one lane completes
+    void Run();
+    SHA256Job* PopDone();
+
+    uint32_t state[8][SHA256_LANES];
+    uint32_t block[16][SHA256_LANES];
+    SHA256LaneJob lanes[SHA256_LANES];
+    SHA256Job* jobs[SHA256_LANES];
+    SHA256Job* done[SHA256_LANES];     // completed jobs, oldest first
+    size_t busy;
+    size_t num_done;
+};
+
+#endif // SHA256_BATCH_H
@@ -0,0 +1,141 @@
+/*
+ * Compile-time SHA256 for HASH256_PTX
+ *
+ * constexpr versions of the compression function, midstates and whole
+ * digests, for inputs known at compile time: tag prefixes, domain
+ * separators, known-answer constants. Results are SHA256ConstDigest values
+ * in the word layout (see sha256_digest.h) and can initialise static tables
+ * or appear in static_assert. Header-only; needs C++14. At run time these
+ * are plain scalar code, so use SHA256 for anything not constant.
+ */
+
+#ifndef SHA256_CONSTEXPR_H
+#define SHA256_CONSTEXPR_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Digest or chaining value as native state words
+struct SHA256ConstDigest {
+    uint32_t w[8];
+
+    constexpr uint32_t operator[](int i) const { return w[i]; }
+    // Byte i of the big-endian digest
+    constexpr uint8_t Byte(int i) const { return (uint8_t)(w[i / 4] >> (24 - 8 * (i % 4))); }
+};
+
+// Own copies of the FIPS 180-4 tables: SHA256_K and SHA256_IV in
+// sha256_ops.h are defined out of line and cannot be read at compile time
+static constexpr uint32_t SHA256_CONST_K[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+static constexpr SHA256ConstDigest SHA256_CONST_IV = {{
+    0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+}};
+
+constexpr uint32_t SHA256ConstRor(uint32_t x, int n) {
+    return (x >> n) | (x << (32 - n));
+}
+
+// Compress one 64-byte block into state. Byte is char or uint8_t.
+template <typename Byte>
+constexpr SHA256ConstDigest SHA256ConstCompress(SHA256ConstDigest state, const Byte* block) {
+    uint32_t w[64] = {};
+    for (int i = 0; i < 16; ++i) {
+        w[i] = ((uint32_t)(uint8_t)block[i * 4] << 24) | ((uint32_t)(uint8_t)block[i * 4 + 1] << 16) |
+               ((uint32_t)(uint8_t)block[i * 4 + 2] << 8) | (uint32_t)(uint8_t)block[i * 4 + 3];
+    }
+    for (int i = 16; i < 64; ++i) {
+        uint32_t s0 = SHA256ConstRor(w[i - 15], 7) ^ SHA256ConstRor(w[i - 15], 18) ^ (w[i - 15] >> 3);
+        uint32_t s1 = SHA256ConstRor(w[i - 2], 17) ^ SHA256ConstRor(w[i - 2], 19) ^ (w[i - 2] >> 10);
+        w[i] = s1 + w[i - 7] + s0 + w[i - 16];
+    }
+
+    uint32_t v[8] = {};
+    for (int i = 0; i < 8; ++i) {
+        v[i] = state.w[i];
+    }
+    for (int i = 0; i < 64; ++i) {
+        uint32_t ep1 = SHA256ConstRor(v[4], 6) ^ SHA256ConstRor(v[4], 11) ^ SHA256ConstRor(v[4], 25);
+        uint32_t ch = (v[4] & v[5]) ^ (~v[4] & v[6]);
+        uint32_t ep0 = SHA256ConstRor(v[0], 2) ^ SHA256ConstRor(v[0], 13) ^ SHA256ConstRor(v[0], 22);
+        uint32_t maj = (v[0] & v[1]) ^ (v[0] & v[2]) ^ (v[1] & v[2]);
+        uint32_t t1 = v[7] + ep1 + ch + SHA256_CONST_K[i] + w[i];
+        uint32_t t2 = ep0 + maj;
+        for (int j = 7; j > 0; --j) {
+            v[j] = v[j - 1];
+        }
+        v[4] += t1;
+        v[0] = t1 + t2;
+    }
+    for (int i = 0; i < 8; ++i) {
+        state.w[i] += v[i];
+    }
+    return state;
+}
+
+// Chaining value after the whole 64-byte blocks of data (trailing bytes
+// past the last full block are ignored), starting from init
+template <typename Byte>
+constexpr SHA256ConstDigest SHA256ConstMidstate(const Byte* data, size_t len,
+                                                SHA256ConstDigest init = SHA256_CONST_IV) {
+    for (size_t offset = 0; offset + 64 <= len; offset += 64) {
+        init = SHA256ConstCompress(init, data + offset);
+    }
+    return init;
+}
+
+// Digest of data, continuing from init after prefix_len bytes (a multiple
+// of 64; use a SHA256ConstMidstate result)
+template <typename Byte>
+constexpr SHA256ConstDigest SHA256ConstHash(const Byte* data, size_t len,
+                                            SHA256ConstDigest init = SHA256_CONST_IV, uint64_t prefix_len = 0) {
+    SHA256ConstDigest state = SHA256ConstMidstate(data, len, init);
+
+    size_t offset = len / 64 * 64;
+    size_t tail = len - offset;
+    size_t tail_len = tail < 56 ? 64 : 128;
+    uint8_t padded[128] = {};
+    for (size_t i = 0; i < tail; ++i) {
+        padded[i] = (uint8_t)data[offset + i];
+    }
+    padded[tail] = 0x80;
+    uint64_t bit_count = (prefix_len + len) * 8;
+    for (int i = 0; i < 8; ++i) {
+        padded[tail_len - 1 - i] = (uint8_t)(bit_count >> (8 * i));
+    }
+
+    state = SHA256ConstCompress(state, padded);
+    if (tail_len == 128) {
+        state = SHA256ConstCompress(state, padded + 64);
+    }
+    return state;
+}
+
+// String literal convenience: hashes the characters without the NUL
+template <size_t N>
+constexpr SHA256ConstDigest SHA256ConstHash(const char (&text)[N]) {
+    return SHA256ConstHash(text, N - 1);
+}
+
+// BIP340 tag midstate: the state after SHA256(tag) || SHA256(tag)
+template <size_t N>
+constexpr SHA256ConstDigest SHA256ConstTagMidstate(const char (&tag)[N]) {
+    SHA256ConstDigest tag_hash = SHA256ConstHash(tag);
+    uint8_t block[64] = {};
+    for (int i = 0; i < 32; ++i) {
+        block[i] = tag_hash.Byte(i);
+        block[32 + i] = tag_hash.Byte(i);
+    }
+    return SHA256ConstCompress(SHA256_CONST_IV, block);
+}
+
+#endif // SHA256_CONSTEXPR_H
@@ -0,0 +1,202 @@
+/*
+ * SHA256 compression core shared by the CPU engines
+ * Implementation header: included by the SHA256 sources, not by callers
+ *
+ * One round function, templated on the lane type T: uint32_t for the scalar
+ * engine, or a SHA256Vec* vector of 4, 8 or 16 words, which GCC and Clang
+ * compile to SSE2, AVX2 or AVX-512 as -march allows (splitting wider
+ * vectors otherwise). Every operator the round uses works on both, so the
+ * same source serves scalar, multi-buffer, fixed-length and HMAC paths.
+ *
+ * Round ranges are expanded at compile time. Working variables never move:
+ * at round i, role r (0 = a .. 7 = h) lives in s[(r - i) & 7], so each
+ * round writes only its new a and new e and the slots are back in order
+ * every 8 rounds. The schedule is kept as a rolling window of 16 words.
+ */
+
+#ifndef SHA256_CORE_H
+#define SHA256_CORE_H
+
+#include <stdint.h>
+#include <string.h>
+#include <utility>
+#include "sha256_ops.h"
+
+// Vectors are only passed by value between static inline functions of one
+// translation unit, so GCC's note about the AVX calling convention does not
+// apply. Scoped to this header so includers keep their own diagnostics.
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpsabi"
+#endif
+
+typedef uint32_t SHA256Vec4 __attribute__((vector_size(16)));
+typedef uint32_t SHA256Vec8 __attribute__((vector_size(32)));
+typedef uint32_t SHA256Vec16 __attribute__((vector_size(64)));
+
+// Two native vectors acting as one twice as wide. Without AVX, GCC splits
+// a SHA256Vec8 through memory; a pair of SHA256Vec4 stays in SSE registers.
+// Same memory image as the wide vector: the low half's lanes come first.
+template <typename V>
+struct SHA256VecPair {
+    V lo, hi;
+
+    uint32_t operator[](int l) const { return l < (int)(sizeof(V) / 4) ? lo[l] : hi[l - sizeof(V) / 4]; }
+    SHA256VecPair& operator+=(const SHA256VecPair& o) { lo += o.lo; hi += o.hi; return *this; }
+    SHA256VecPair& operator+=(uint32_t x) { lo += x; hi += x; return *this; }
+};
+
+#define SHA256_VEC_PAIR_OP(op)                                                                    \
+    template <typename V>                                                                         \
+    static inline SHA256VecPair<V> operator op(const SHA256VecPair<V>& x, const SHA256VecPair<V>& y) { \
+        SHA256VecPair<V> r = {x.lo op y.lo, x.hi op y.hi};                                        \
+        return r;                                                                                 \
+    }
+SHA256_VEC_PAIR_OP(+)
+SHA256_VEC_PAIR_OP(^)
+SHA256_VEC_PAIR_OP(&)
+SHA256_VEC_PAIR_OP(|)
+#undef SHA256_VEC_PAIR_OP
+
+template <typename V>
+static inline SHA256VecPair<V> operator+(const SHA256VecPair<V>& x, uint32_t k) {
+    SHA256VecPair<V> r = {x.lo + k, x.hi + k};
+    return r;
+}
+
+template <typename V>
+static inline SHA256VecPair<V> operator~(const SHA256VecPair<V>& x) {
+    SHA256VecPair<V> r = {~x.lo, ~x.hi};
+    return r;
+}
+
+template <typename V>
+static inline SHA256VecPair<V> operator>>(const SHA256VecPair<V>& x, int n) {
+    SHA256VecPair<V> r = {x.lo >> n, x.hi >> n};
+    return r;
+}
+
+template <typename V>
+static inline SHA256VecPair<V> operator<<(const SHA256VecPair<V>& x, int n) {
+    SHA256VecPair<V> r = {x.lo << n, x.hi << n};
+    return r;
+}
+
+// Round I. kw is K[I] + W[I], a lane value or a scalar shared by all lanes.
+template <int I, typename T, typename KW>
+static inline void SHA256CoreRound(T s[8], const KW& kw) {
+    T& a = s[(0 - I) & 7];
+    T& b = s[(1 - I) & 7];
+    T& c = s[(2 - I) & 7];
+    T& d = s[(3 - I) & 7];
+    T& e = s[(4 - I) & 7];
+    T& f = s[(5 - I) & 7];
+    T& g = s[(6 - I) & 7];
+    T& h = s[(7 - I) & 7];
+    T t1 = h + EP1(e) + CH(e, f, g) + kw;
+    T t2 = EP0(a) + MAJ(a, b, c);
+    d += t1;
+    h = t1 + t2;
+}
+
+// Round with a run-time index: the roles move down one slot instead, so
+// s stays a..h. For the few leading rounds of a prefix that do not start
+// on a multiple of 8.
+template <typename T, typename KW>
+static inline void SHA256CoreRoundShift(T s[8], const KW& kw) {
+    T t1 = s[7] + EP1(s[4]) + CH(s[4], s[5], s[6]) + kw;
+    T t2 = EP0(s[0]) + MAJ(s[0], s[1], s[2]);
+    for (int i = 7; i > 0; --i) {
+        s[i] = s[i - 1];
+    }
+    s[4] += t1;
+    s[0] = t1 + t2;
+}
+
+// W[I] in the rolling window: the block word for I < 16, otherwise computed
+// over the slot of W[I - 16]
+template <int I, typename T>
+static inline T SHA256CoreSchedule(T w[16]) {
+    if (I >= 16) {
+        w[I & 15] += SIG1(w[(I - 2) & 15]) + w[(I - 7) & 15] + SIG0(w[(I - 15) & 15]);
+    }
+    return w[I & 15];
+}
+
+// Sources of K[i] + W[i] for the unrolled ranges below
+template <typename T>
+struct SHA256CoreRolling {
+    T* w;                        // 16-word window, block words on entry
+    template <int I> T Get() const { return SHA256CoreSchedule<I>(w) + SHA256_K[I]; }
+};
+
+template <typename T>
+struct SHA256CoreExpanded {
+    const T* w;                  // all 64 schedule words
+    template <int I> T Get() const { return w[I] + SHA256_K[I]; }
+};
+
+struct SHA256CoreConstant {
+    const uint32_t* kw;          // K[i] + W[i] of a constant block
+    template <int I> uint32_t Get() const { return kw[I]; }
+};
+
+template <int FIRST, typename T, typename Source, int... I>
+static inline void SHA256CoreRoundsSeq(T s[8], const Source& source, std::integer_sequence<int, I...>) {
+    // Braced-list elements are evaluated in order, one round each
+    int order[] = {0, (SHA256CoreRound<FIRST + I>(s, source.template Get<FIRST + I>()), 0)...};
+    (void)order;
+}
+
+// Rounds FIRST..END-1, unrolled. s holds role r in s[(r - FIRST) & 7].
+template <int FIRST, int END, typename T, typename Source>
+static inline void SHA256CoreRounds(T s[8], const Source& source) {
+    SHA256CoreRoundsSeq<FIRST>(s, source, std::make_integer_sequence<int, END - FIRST>());
+}
+
+// state += compression of block (16 words in the lane type)
+template <typename T>
+static inline void SHA256CoreTransform(T state[8], const T block[16]) {
+    T s[8], w[16];
+    for (int i = 0; i < 8; ++i) {
+        s[i] = state[i];
+    }
+    for (int i = 0; i < 16; ++i) {
+        w[i] = block[i];
+    }
+    SHA256CoreRolling<T> source = {w};
+    SHA256CoreRounds<0, 64>(s, source);
+    for (int i = 0; i < 8; ++i) {
+        state[i] += s[i];
+    }
+}
+
+// state += compression of a block known at compile time, given as the 64
+// sums K[i] + W[i]: no schedule to compute
+template <typename T>
+static inline void SHA256CoreTransformConstant(T state[8], const uint32_t kw[64]) {
+    T s[8];
+    for (int i = 0; i < 8; ++i) {
+        s[i] = state[i];
+    }
+    SHA256CoreConstant source = {kw};
+    SHA256CoreRounds<0, 64>(s, source);
+    for (int i = 0; i < 8; ++i) {
+        state[i] += s[i];
+    }
+}
+
+// Scalar transform straight from 64 message bytes
+static inline void SHA256CoreTransformBytes(uint32_t state[8], const uint8_t* data) {
+    uint32_t block[16];
+    for (int i = 0; i < 16; ++i) {
+        block[i] = ReadBE32(data + i * 4);
+    }
+    SHA256CoreTransform(state, block);
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+#endif // SHA256_CORE_H
@@ -0,0 +1,32 @@
+/*
+ * Digest layout helpers for HASH256_PTX
+ *
+ * Digests come in two layouts: the 32 big-endian bytes defined by SHA256,
+ * and eight native-endian uint32_t words (the raw state, as written by
+ * kernels generated with --output-layout words and by SHA256::FinalWords).
+ * Consumers that only compare digests can stay in the word layout; word
+ * order compares the same way as memcmp() on the byte layout.
+ */
+
+#ifndef SHA256_DIGEST_H
+#define SHA256_DIGEST_H
+
+#include <stdint.h>
+#include <string.h>
+
+// Convert count digests between layouts. Conversion is a per-word byte swap,
+// so the two functions are the same operation; in-place use is allowed.
+void DigestWordsToBytes(const uint32_t* words, uint8_t* bytes, size_t count);
+void DigestBytesToWords(const uint8_t* bytes, uint32_t* words, size_t count);
+
+// Compare two word-layout digests.
+// DigestWordsCompare orders like memcmp() on the equivalent byte layout.
+bool DigestWordsEqual(const uint32_t* a, const uint32_t* b);
+int DigestWordsCompare(const uint32_t* a, const uint32_t* b);
+
+// Scan count word-layout digests for target. Indices of matches are written
+// to indices (up to max_indices of them); returns the total number of matches.
+size_t DigestWordsFind(const uint32_t* digests, size_t count, const uint32_t* target,
+                       uint32_t* indices, size_t max_indices);
+
+#endif // SHA256_DIGEST_H
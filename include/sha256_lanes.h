@@ -0,0 +1,57 @@
+/*
+ * Lane-parallel SHA256 for HASH256_PTX
+ *
+ * Compresses SHA256_LANES independent messages at once. State and message
+ * words are kept in structure-of-arrays form (word-major, lane-minor) so that
+ * every statement of the round function is a loop over lanes the compiler can
+ * map onto one SIMD instruction. Results stay as native state words, ready to
+ * feed another hash without serialising to bytes.
+ */
+
+#ifndef SHA256_LANES_H
+#define SHA256_LANES_H
+
+#include <stdint.h>
+#include <string.h>
+#include "sha256_prefix.h"
+
+#define SHA256_LANES 8
+
+// One compression per lane: state[i][lane] is word i of that lane's state,
+// block[i][lane] is big-endian message word i of that lane's block
+void SHA256TransformLanes(uint32_t state[8][SHA256_LANES], const uint32_t block[16][SHA256_LANES]);
+
+// Match-mode compression: runs rounds 0..60, after which the final H7 and H3
+// of every lane are fixed (the last three rounds only shift them into place),
+// and asks test about each lane. Only if some lane is accepted are rounds
+// 61..63 run and state updated. Returns the mask of accepted lanes; on 0
+// state is left as it was.
+typedef bool (*SHA256LaneTest)(uint32_t h7, uint32_t h3, const void* ctx);
+uint32_t SHA256TransformLanesMatch(uint32_t state[8][SHA256_LANES], const uint32_t block[16][SHA256_LANES],
+                                   SHA256LaneTest test, const void* ctx);
+
+// Fixed-prefix compression (see sha256_prefix.h): only the varying words of
+// each lane's block are read. Writes the chaining value per lane.
+void SHA256TransformLanesPrefix(const SHA256Prefix& prefix, const uint32_t block[16][SHA256_LANES],
+                                uint32_t out[8][SHA256_LANES]);
+
+// Same with a chaining value per lane, for blocks whose fixed words are the
+// same in every lane but whose states differ (e.g. HMAC iterations under
+// different keys). Word 0 must be varying (prefix.rounds == 0); prefix.state
+// and prefix.init are not used. out may alias block.
+void SHA256TransformLanesPrefixChained(const SHA256Prefix& prefix, const uint32_t init[8][SHA256_LANES],
+                                       const uint32_t block[16][SHA256_LANES], uint32_t out[8][SHA256_LANES]);
+
+// SHA256 of one 64-byte message per lane (e.g. a Merkle node: two child
+// digests). block[i][lane] is big-endian word i of that lane's message; the
+// padding block is a constant schedule table. Writes the final state words.
+void SHA256Hash64Lanes(const uint32_t block[16][SHA256_LANES], uint32_t out[8][SHA256_LANES]);
+
+// Hash SHA256_LANES messages of len bytes each, continuing from init (a
+// state reached after prefix_len bytes; pass SHA256_IV and 0 for a plain
+// hash). Lanes may share a data pointer. Writes the final state words.
+void SHA256HashLanes(const uint32_t init[8], uint64_t prefix_len,
+                     const uint8_t* const data[SHA256_LANES], size_t len,
+                     uint32_t out[8][SHA256_LANES]);
+
+#endif // SHA256_LANES_H
@@ -0,0 +1,26 @@
+/*
+ * Match-mode SHA256 batches for HASH256_PTX
+ *
+ * In a filter-dominated search almost every digest is thrown away, so only
+ * the words the filter needs are computed up front. With a filter keyed on
+ * H7/H3 (TARGET_FILTER_KEY_H7H3) the final compression stops after round 60
+ * for every key that cannot match; only candidates run the last three rounds
+ * and get a full digest. This is the CPU counterpart of the PTX generator's
+ * --output-layout match kernels and produces the same hit records.
+ */
+
+#ifndef SHA256_MATCH_H
+#define SHA256_MATCH_H
+
+#include <stdint.h>
+#include <string.h>
+#include "target_filter.h"
+
+// Hash count messages of len bytes each (stored back to back) and collect
+// the ones whose digest passes filter, in ascending index order. Up to
+// max_hits records are stored; returns the total number of hits.
+// Filters keyed on H0/H1 work too, without the early exit.
+size_t SHA256MatchBatch(const TargetFilter& filter, const uint8_t* data, size_t len, size_t count,
+                        TargetHit* hits, size_t max_hits);
+
+#endif // SHA256_MATCH_H
@@ -0,0 +1,28 @@
+/*
+ * Fixed 64-byte SHA256 for HASH256_PTX
+ *
+ * A Merkle internal node hashes exactly two 32-byte child digests. With the
+ * length fixed, the second compression block is pure padding and its whole
+ * schedule is a constant table, and the children can stay in native word
+ * form (see sha256_digest.h) from one tree level to the next. This is the
+ * CPU counterpart of kernels generated with --input-mode node64.
+ */
+
+#ifndef SHA256_NODE_H
+#define SHA256_NODE_H
+
+#include <stdint.h>
+#include <string.h>
+
+// Parents of count nodes. children holds 16 native words per node (the left
+// child's 8 digest words, then the right child's); parents receives 8 words
+// per node. parents may equal children: node i is read before parent i is
+// written and parent i never overlaps a later node.
+void SHA256Node64Batch(const uint32_t* children, uint32_t* parents, size_t count);
+
+// Same for SHA256d (Bitcoin Merkle nodes): each 64-byte node is hashed, then
+// its 32-byte digest is hashed again. The second hash's padding words are
+// fixed, so its schedule starts from a precomputed SHA256Prefix.
+void SHA256dNode64Batch(const uint32_t* children, uint32_t* parents, size_t count);
+
+#endif // SHA256_NODE_H
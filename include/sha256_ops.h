@@ -0,0 +1,38 @@
+/*
+ * SHA256 round primitives shared by the CPU engines
+ * Implementation header: included by the SHA256 sources, not by callers
+ */
+
+#ifndef SHA256_OPS_H
+#define SHA256_OPS_H
+
+#include <stdint.h>
+
+#define ROR(x, n) (((x) >> (n)) | ((x) << (32 - (n))))
+#define CH(x, y, z) (((x) & (y)) ^ (~(x) & (z)))
+#define MAJ(x, y, z) (((x) & (y)) ^ ((x) & (z)) ^ ((y) & (z)))
+#define EP0(x) (ROR(x, 2) ^ ROR(x, 13) ^ ROR(x, 22))
+#define EP1(x) (ROR(x, 6) ^ ROR(x, 11) ^ ROR(x, 25))
+#define SIG0(x) (ROR(x, 7) ^ ROR(x, 18) ^ ((x) >> 3))
+#define SIG1(x) (ROR(x, 17) ^ ROR(x, 19) ^ ((x) >> 10))
+
+// Round constants and initial hash value (FIPS 180-4), defined in sha256.cpp
+extern const uint32_t SHA256_K[64];
+extern const uint32_t SHA256_IV[8];
+
+static inline uint32_t ReadBE32(const uint8_t* p) {
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | (uint32_t)p[3];
+}
+
+static inline void WriteBE32(uint8_t* p, uint32_t x) {
+    p[0] = (uint8_t)(x >> 24);
+    p[1] = (uint8_t)(x >> 16);
+    p[2] = (uint8_t)(x >> 8);
+    p[3] = (uint8_t)x;
+}
+
+static inline uint32_t Bswap32(uint32_t x) {
+    return (x >> 24) | ((x >> 8) & 0x0000ff00) | ((x << 8) & 0x00ff0000) | (x << 24);
+}
+
+#endif // SHA256_OPS_H
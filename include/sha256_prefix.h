@@ -0,0 +1,49 @@
+/*
+ * Fixed-prefix SHA256 compression for HASH256_PTX
+ *
+ * When a batch of blocks differs only in a few message words, everything
+ * that depends on the other words alone is the same for every block: the
+ * rounds before the first varying word, and in each later schedule word the
+ * terms built from fixed words. A SHA256Prefix holds those values, computed
+ * once per batch; the lane engine and the prefix PTX kernels
+ * (--input-mode prefix) start from it and only do the per-block rest.
+ */
+
+#ifndef SHA256_PREFIX_H
+#define SHA256_PREFIX_H
+
+#include <stdint.h>
+#include <string.h>
+
+// state and schedule come first and back to back: they are the prefix
+// kernel's 288-byte parameter (PREFIX_PARAM_BYTES in the generator).
+struct SHA256Prefix {
+    // Working variables a..h after the first `rounds` rounds
+    uint32_t state[8];
+    // Per round t: W[t] if it is fixed; otherwise, for t < 16 the block word
+    // (its varying bits must be zero), for t >= 16 the sum of the schedule
+    // terms that only depend on fixed words
+    uint32_t schedule[64];
+    // Chaining value the block is compressed into
+    uint32_t init[8];
+    // Leading rounds folded into state (the index of the first varying word)
+    uint32_t rounds;
+    // Bit i set if block word i varies
+    uint32_t varying_words;
+    // Bit t set if W[t] depends on a varying word
+    uint64_t varying;
+};
+
+// Varying-schedule mask for a set of varying block words
+uint64_t SHA256PrefixVarying(uint32_t varying_words);
+
+// Precompute a prefix for blocks equal to block except in the words flagged
+// in varying_words (non-zero, bits 0..15), compressed into init
+void SHA256PrefixInit(SHA256Prefix& prefix, const uint32_t init[8], const uint32_t block[16],
+                      uint32_t varying_words);
+
+// Compress one block given by its varying words (the others are ignored)
+// and write the resulting chaining value
+void SHA256PrefixTransform(const SHA256Prefix& prefix, const uint32_t block[16], uint32_t out[8]);
+
+#endif // SHA256_PREFIX_H
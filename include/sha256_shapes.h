@@ -0,0 +1,146 @@
+/*
+ * Fixed-length SHA256 shapes for HASH256_PTX
+ * Generated by src/sha256_shapes.py from the same shape table as the PTX
+ * kernels; do not edit.
+ *
+ * SHA256Shape<Name>(state, data) runs every compression of a message of
+ * the shape's length from state (normally SHA256_IV): data holds its
+ * message words, big-endian, bits past the last message byte zero, and
+ * padding words and padding-only blocks are compile-time constants. T is
+ * uint32_t or a lane vector of the shared core.
+ *
+ * A block mixing data and padding is also given as SHA256_SHAPE_<NAME>_BLOCK<b>
+ * with SHA256_SHAPE_<NAME>_VARYING<b>, ready for SHA256PrefixInit.
+ */
+
+#ifndef SHA256_SHAPES_H
+#define SHA256_SHAPES_H
+
+#include "sha256_core.h"
+
+// 33-byte message, a compressed public key: 1 block, 9 data words
+#define SHA256_SHAPE_KEY33_BYTES 33
+#define SHA256_SHAPE_KEY33_DATA_WORDS 9
+
+// Block 0 with its data words zero, and those words as a mask (bit i for
+// word i): a SHA256Prefix block for messages of this shape
+static const uint32_t SHA256_SHAPE_KEY33_BLOCK0[16] = {
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00800000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000108
+};
+#define SHA256_SHAPE_KEY33_VARYING0 0x01ffu
+
+template <typename T>
+static inline void SHA256ShapeKey33(T state[8], const T data[9]) {
+    T w[16];
+    w[0] = data[0];
+    w[1] = data[1];
+    w[2] = data[2];
+    w[3] = data[3];
+    w[4] = data[4];
+    w[5] = data[5];
+    w[6] = data[6];
+    w[7] = data[7];
+    w[8] = data[8] | (T() + 0x00800000u);
+    w[9] = T();
+    w[10] = T();
+    w[11] = T();
+    w[12] = T();
+    w[13] = T();
+    w[14] = T();
+    w[15] = T() + 0x00000108u;
+    SHA256CoreTransform(state, w);
+}
+
+// 32-byte message, a digest (the second hash of SHA256d): 1 block, 8 data words
+#define SHA256_SHAPE_DIGEST32_BYTES 32
+#define SHA256_SHAPE_DIGEST32_DATA_WORDS 8
+
+// Block 0 with its data words zero, and those words as a mask (bit i for
+// word i): a SHA256Prefix block for messages of this shape
+static const uint32_t SHA256_SHAPE_DIGEST32_BLOCK0[16] = {
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x80000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000100
+};
+#define SHA256_SHAPE_DIGEST32_VARYING0 0x00ffu
+
+template <typename T>
+static inline void SHA256ShapeDigest32(T state[8], const T data[8]) {
+    T w[16];
+    w[0] = data[0];
+    w[1] = data[1];
+    w[2] = data[2];
+    w[3] = data[3];
+    w[4] = data[4];
+    w[5] = data[5];
+    w[6] = data[6];
+    w[7] = data[7];
+    w[8] = T() + 0x80000000u;
+    w[9] = T();
+    w[10] = T();
+    w[11] = T();
+    w[12] = T();
+    w[13] = T();
+    w[14] = T();
+    w[15] = T() + 0x00000100u;
+    SHA256CoreTransform(state, w);
+}
+
+// 64-byte message, a Merkle node (two child digests): 2 blocks, 16 data words
+#define SHA256_SHAPE_NODE64_BYTES 64
+#define SHA256_SHAPE_NODE64_DATA_WORDS 16
+
+// K[i] + W[i] of block 1: padding only
+static const uint32_t SHA256_SHAPE_NODE64_KW1[64] = {
+    0xc28a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf374,
+    0x649b69c1, 0xf0fe4786, 0x0fe1edc6, 0x240cf254, 0x4fe9346f, 0x6cc984be, 0x61b9411e, 0x16f988fa,
+    0xf2c65152, 0xa88e5a6d, 0xb019fc65, 0xb9d99ec7, 0x9a1231c3, 0xe70eeaa0, 0xfdb1232b, 0xc7353eb0,
+    0x3069bad5, 0xcb976d5f, 0x5a0f118f, 0xdc1eeefd, 0x0a35b689, 0xde0b7a04, 0x58f4ca9d, 0xe15d5b16,
+    0x007f3e86, 0x37088980, 0xa507ea32, 0x6fab9537, 0x17406110, 0x0d8cd6f1, 0xcdaa3b6d, 0xc0bbbe37,
+    0x83613bda, 0xdb48a363, 0x0b02e931, 0x6fd15ca7, 0x521afaca, 0x31338431, 0x6ed41a95, 0x6d437890,
+    0xc39c91f2, 0x9eccabbd, 0xb5c9a0e6, 0x532fb63c, 0xd2c741c6, 0x07237ea3, 0xa4954b68, 0x4c191d76
+};
+
+template <typename T>
+static inline void SHA256ShapeNode64(T state[8], const T data[16]) {
+    SHA256CoreTransform(state, data);
+    SHA256CoreTransformConstant(state, SHA256_SHAPE_NODE64_KW1);
+}
+
+// 80-byte message, a Bitcoin block header: 2 blocks, 20 data words
+#define SHA256_SHAPE_HEADER80_BYTES 80
+#define SHA256_SHAPE_HEADER80_DATA_WORDS 20
+
+// Block 1 with its data words zero, and those words as a mask (bit i for
+// word i): a SHA256Prefix block for messages of this shape
+static const uint32_t SHA256_SHAPE_HEADER80_BLOCK1[16] = {
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x80000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000280
+};
+#define SHA256_SHAPE_HEADER80_VARYING1 0x000fu
+
+template <typename T>
+static inline void SHA256ShapeHeader80(T state[8], const T data[20]) {
+    T w[16];
+    SHA256CoreTransform(state, data);
+    w[0] = data[16];
+    w[1] = data[17];
+    w[2] = data[18];
+    w[3] = data[19];
+    w[4] = T() + 0x80000000u;
+    w[5] = T();
+    w[6] = T();
+    w[7] = T();
+    w[8] = T();
+    w[9] = T();
+    w[10] = T();
+    w[11] = T();
+    w[12] = T();
+    w[13] = T();
+    w[14] = T();
+    w[15] = T() + 0x00000280u;
+    SHA256CoreTransform(state, w);
+}
+
+#endif // SHA256_SHAPES_H
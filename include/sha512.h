@@ -0,0 +1,55 @@
+/*
+ * SHA512 and SHA-512/256 for HASH256_PTX
+ *
+ * Same structure as SHA256 with 64-bit words, 80 rounds and 128-byte
+ * blocks. SHA-512/256 is SHA512 from its own IV, truncated to 32 bytes; on
+ * 64-bit cores it moves twice the bytes per round of SHA256, so it is the
+ * faster 256-bit digest for large payloads.
+ */
+
+#ifndef SHA512_H
+#define SHA512_H
+
+#include <stdint.h>
+#include <string.h>
+
+class SHA512 {
+public:
+    SHA512();
+    void Init();
+    // Start from another IV (e.g. SHA512_256_IV in sha512_ops.h)
+    void Init(const uint64_t iv[8]);
+    void Update(const uint8_t* data, size_t len);
+    void Final(uint8_t hash[64]);
+    void FinalWords(uint64_t hash[8]);
+
+    // Chaining value after the whole blocks consumed so far, and resuming
+    // from one taken after len bytes (a multiple of 128)
+    void Midstate(uint64_t out[8]) const;
+    void SetMidstate(const uint64_t in[8], uint64_t len);
+
+    static void Hash(const uint8_t* data, size_t len, uint8_t hash[64]);
+
+private:
+    void Transform(const uint8_t* data);
+    void Pad();
+
+    uint64_t state[8];
+    uint64_t count;
+    uint8_t buffer[128];
+};
+
+class SHA512_256 {
+public:
+    SHA512_256();
+    void Init();
+    void Update(const uint8_t* data, size_t len);
+    void Final(uint8_t hash[32]);
+
+    static void Hash(const uint8_t* data, size_t len, uint8_t hash[32]);
+
+private:
+    SHA512 sha;
+};
+
+#endif // SHA512_H
@@ -0,0 +1,29 @@
+/*
+ * Lane-parallel SHA512 for HASH256_PTX
+ *
+ * The SHA512 counterpart of sha256_lanes.h: SHA512_LANES independent
+ * messages in structure-of-arrays form, one loop over lanes per statement.
+ * Lanes hold 64-bit words, so four of them fill a 256-bit vector.
+ */
+
+#ifndef SHA512_LANES_H
+#define SHA512_LANES_H
+
+#include <stdint.h>
+#include <string.h>
+
+#define SHA512_LANES 4
+
+// One compression per lane: state[i][lane] is word i of that lane's state,
+// block[i][lane] is big-endian message word i of that lane's block
+void SHA512TransformLanes(uint64_t state[8][SHA512_LANES], const uint64_t block[16][SHA512_LANES]);
+
+// Hash SHA512_LANES messages of len bytes each, continuing from init (a
+// state reached after prefix_len bytes; pass SHA512_IV and 0 for a plain
+// hash, SHA512_256_IV and 0 for SHA-512/256). Lanes may share a data
+// pointer. Writes the final state words.
+void SHA512HashLanes(const uint64_t init[8], uint64_t prefix_len,
+                     const uint8_t* const data[SHA512_LANES], size_t len,
+                     uint64_t out[8][SHA512_LANES]);
+
+#endif // SHA512_LANES_H
@@ -0,0 +1,39 @@
+/*
+ * SHA512 round primitives shared by the CPU engines
+ * Implementation header: included by the SHA512 sources, not by callers
+ */
+
+#ifndef SHA512_OPS_H
+#define SHA512_OPS_H
+
+#include <stdint.h>
+
+#define ROR64(x, n) (((x) >> (n)) | ((x) << (64 - (n))))
+#define CH64(x, y, z) (((x) & (y)) ^ (~(x) & (z)))
+#define MAJ64(x, y, z) (((x) & (y)) ^ ((x) & (z)) ^ ((y) & (z)))
+#define EP0_64(x) (ROR64(x, 28) ^ ROR64(x, 34) ^ ROR64(x, 39))
+#define EP1_64(x) (ROR64(x, 14) ^ ROR64(x, 18) ^ ROR64(x, 41))
+#define SIG0_64(x) (ROR64(x, 1) ^ ROR64(x, 8) ^ ((x) >> 7))
+#define SIG1_64(x) (ROR64(x, 19) ^ ROR64(x, 61) ^ ((x) >> 6))
+
+// Round constants and initial hash values (FIPS 180-4), defined in sha512.cpp
+extern const uint64_t SHA512_K[80];
+extern const uint64_t SHA512_IV[8];
+extern const uint64_t SHA512_256_IV[8];
+
+static inline uint64_t ReadBE64(const uint8_t* p) {
+    uint64_t x = 0;
+    for (int i = 0; i < 8; ++i) {
+        x = (x << 8) | p[i];
+    }
+    return x;
+}
+
+static inline void WriteBE64(uint8_t* p, uint64_t x) {
+    for (int i = 7; i >= 0; --i) {
+        p[i] = (uint8_t)x;
+        x >>= 8;
+    }
+}
+
+#endif // SHA512_OPS_H
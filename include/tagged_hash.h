@@ -0,0 +1,48 @@
+/*
+ * BIP340 tagged hashes for HASH256_PTX
+ *
+ * TaggedHash(tag, msg) = SHA256(SHA256(tag) || SHA256(tag) || msg). The two
+ * tag digests fill exactly one block, so every message under a tag starts
+ * from the same midstate. A TaggedHashTag holds that midstate; build it once
+ * per tag (TaggedHashTagInit, or the process-wide cache behind TaggedHashTagFor)
+ * and each message then costs only its own blocks.
+ */
+
+#ifndef TAGGED_HASH_H
+#define TAGGED_HASH_H
+
+#include <stdint.h>
+#include <string.h>
+#include "sha256_constexpr.h"
+
+struct TaggedHashTag {
+    uint32_t midstate[8];         // state after the 64-byte tag prefix
+};
+
+void TaggedHashTagInit(TaggedHashTag& tag, const uint8_t* name, size_t len);
+
+// Tag for a name known at compile time, with no cache lookup:
+//   static constexpr TaggedHashTag challenge = TaggedHashConstTag("BIP0340/challenge");
+template <size_t N>
+constexpr TaggedHashTag TaggedHashConstTag(const char (&name)[N]) {
+    SHA256ConstDigest midstate = SHA256ConstTagMidstate(name);
+    TaggedHashTag tag = {};
+    for (int i = 0; i < 8; ++i) {
+        tag.midstate[i] = midstate[i];
+    }
+    return tag;
+}
+
+// Cached tag for a NUL-terminated name (e.g. "BIP0340/challenge", "TapLeaf").
+// The first call per name computes it; the reference stays valid for the
+// life of the process. Thread-safe.
+const TaggedHashTag& TaggedHashTagFor(const char* name);
+
+void TaggedHash(const TaggedHashTag& tag, const uint8_t* msg, size_t len, uint8_t hash[32]);
+void TaggedHash(const char* tag, const uint8_t* msg, size_t len, uint8_t hash[32]);
+
+// count messages of len bytes each, stored back to back, under one tag.
+// Runs SHA256_LANES messages at a time from the tag midstate.
+void TaggedHashBatch(const TaggedHashTag& tag, const uint8_t* msgs, size_t len, uint8_t* hashes, size_t count);
+
+#endif // TAGGED_HASH_H
@@ -0,0 +1,78 @@
+/*
+ * Target filter for HASH256_PTX
+ *
+ * A split-block Bloom filter over SHA256 digests in the word layout (see
+ * sha256_digest.h). The filter is an array of 256-bit blocks, a power of two
+ * of them. A digest selects block (H0 & block_mask), then sets or tests one
+ * bit in each of the block's eight words: bit (H1 * salt[i]) >> 27 of word i.
+ * A probe is two 128-bit loads on the GPU, with no false negatives and
+ * roughly 0.1% false positives at the default 16 bits per target.
+ *
+ * Match-mode filters (TARGET_FILTER_KEY_H7H3) use H7 and H3 in place of H0
+ * and H1: both are final after round 60 of 64, so non-candidates can be
+ * rejected three rounds early.
+ *
+ * Kernels generated with --output-layout filter run the probe on every digest
+ * and report candidates as a hit list: an array of max_hits uint32_t key
+ * indices (in arbitrary order) plus a uint32_t hit count. The count keeps
+ * counting past max_hits, so count > max_hits means the list overflowed.
+ * Match kernels (--output-layout match) store TargetHit records instead:
+ * the key index followed by the candidate's digest words.
+ * Hits are candidates only; confirm them against the exact target set.
+ */
+
+#ifndef TARGET_FILTER_H
+#define TARGET_FILTER_H
+
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+
+#define TARGET_FILTER_BLOCK_WORDS 8
+
+// Digest words a filter is keyed on: the block word, then the bit word
+enum TargetFilterKey {
+    TARGET_FILTER_KEY_H0H1 = 0,   // filter kernels, full digest
+    TARGET_FILTER_KEY_H7H3 = 1    // match kernels, known after round 60
+};
+
+// Hit record of match kernels and SHA256MatchBatch
+struct TargetHit {
+    uint32_t index;
+    uint32_t digest[8];           // word layout
+};
+
+class TargetFilter {
+public:
+    TargetFilter();
+
+    // Size for expected_targets digests and clear. The block count is rounded
+    // up to a power of two, so the real budget is at least bits_per_target.
+    void Init(size_t expected_targets, size_t bits_per_target = 16,
+              TargetFilterKey key = TARGET_FILTER_KEY_H0H1);
+    void Insert(const uint32_t digest[8]);
+    void InsertBatch(const uint32_t* digests, size_t count);
+
+    // CPU reference probe, bit-identical to the kernel's
+    bool MayContain(const uint32_t digest[8]) const;
+    bool MayContainKey(uint32_t block_word, uint32_t bit_word) const;
+    TargetFilterKey Key() const { return key; }
+
+    // Device image: NumBlocks() * 8 words, BlockMask() = NumBlocks() - 1
+    const uint32_t* Data() const { return blocks.empty() ? NULL : &blocks[0]; }
+    size_t SizeBytes() const { return blocks.size() * sizeof(uint32_t); }
+    uint32_t NumBlocks() const { return (uint32_t)(blocks.size() / TARGET_FILTER_BLOCK_WORDS); }
+    uint32_t BlockMask() const { return NumBlocks() - 1; }
+
+private:
+    std::vector<uint32_t> blocks;
+    TargetFilterKey key;
+};
+
+// CPU reference matcher: probe count word-layout digests and build the hit
+// list a filter kernel would produce (indices in ascending order). Returns
+// the total number of hits, which may exceed max_hits.
+size_t TargetFilterMatch(const TargetFilter& filter, const uint32_t* digests, size_t count,
+                         uint32_t* hits, size_t max_hits);
+
+#endif // TARGET_FILTER_H
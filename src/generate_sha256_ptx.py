@@ -4,15 +4,67 @@ Generate complete SHA256 PTX kernel with all 64 rounds
 This script generates the full unrolled SHA256 implementation
 """
 
-def generate_round(round_num, w_expr):
-    """Generate PTX code for one SHA256 round"""
+import argparse
+import re
+
+from sha256_shapes import SHA256_K, SHAPES, constant_kw, known_schedule, sigma0, sigma1
+
+# Kernel shape identifiers, exported through the sha256_kernel_info constant
+# so the host wrapper can check it is driving the kernel it expects.
+# Keep in sync with PTXInputMode / PTXOutputMode in include/ptx_sha256.hpp.
+INPUT_MODES = {"keys33": 0, "counter": 1, "prefix": 2, "node64": 3, "arena": 4}
+OUTPUT_MODES = {"bytes": 0, "words": 1, "filter": 2, "match": 3}
+
+# Output layouts that return a hit list instead of digests
+HIT_LIST_LAYOUTS = ("filter", "match")
+
+# Input modes that build keys on the device from a base record and counter
+ENUMERATED_INPUTS = ("counter", "prefix")
+
+# Bytes per input record for the modes that read keys from param_input
+INPUT_RECORD_BYTES = {"keys33": 33, "node64": 64}
+
+# Arena entry table record: u64 offset, u32 length, u32 output index.
+# Keep in sync with SHA256ArenaEntry in include/sha256_arena.h.
+ARENA_ENTRY_BYTES = 16
+
+# Maximum number of key counter bytes (a 64-bit counter)
+COUNTER_MAX_BYTES = 8
+
+# Prefix kernel parameter: the working variables after the host-side rounds,
+# then one schedule entry per round. Keep in sync with SHA256Prefix in
+# include/sha256_prefix.h.
+PREFIX_SCHEDULE_OFFSET = 32
+PREFIX_PARAM_BYTES = PREFIX_SCHEDULE_OFFSET + 64 * 4
+
+# Split-block Bloom filter salts, one per 32-bit word of a 256-bit block.
+# Keep in sync with TARGET_FILTER_SALT in src/target_filter.cpp.
+FILTER_SALT = [0x47b6137b, 0x44974d91, 0x8824ad5b, 0xa2b7289d,
+               0x705495c7, 0x2df1424b, 0x9efc4947, 0x5c6bfb31]
+
+def generate_round(round_num, w_expr, kw=None):
+    """Generate PTX code for one SHA256 round
+    
+    With kw (a known K[t] + W[t]) the constant load and the W add are
+    replaced by one immediate add.
+    """
     k_offset = round_num * 4
     
+    if kw is None:
+        k_load = f"""    ld.const.u32    %k_val, [K+{k_offset}];
+    {w_expr}
+"""
+        kw_add = """    add.u32         %t1, %t1, %k_val;
+    add.u32         %t1, %t1, %w_val;
+"""
+    else:
+        k_load = ""
+        kw_add = f"""    add.u32         %t1, %t1, 0x{kw:08x};
+"""
+    
     code = f"""
     // Round {round_num}
-    ld.const.u32    %k_val, [K+{k_offset}];
-    {w_expr}
-    // Ch(e,f,g) = (e & f) ^ (~e & g)
+{k_load}    // Ch(e,f,g) = (e & f) ^ (~e & g)
     and.b32         %r10, %e, %f;
     not.b32         %r11, %e;
     and.b32         %r11, %r11, %g;
@@ -50,9 +102,7 @@ def generate_round(round_num, w_expr):
     // t1 = h + Sigma1 + ch + k + w
     add.u32         %t1, %h, %S1;
     add.u32         %t1, %t1, %ch;
-    add.u32         %t1, %t1, %k_val;
-    add.u32         %t1, %t1, %w_val;
-    // t2 = Sigma0 + maj
+{kw_add}    // t2 = Sigma0 + maj
     add.u32         %t2, %S0, %maj;
     // Update working variables
     mov.u32         %h, %g;
@@ -67,22 +117,10 @@ def generate_round(round_num, w_expr):
     
     return code
 
-def generate_message_schedule_extension(i):
-    """Generate code to extend message schedule for round i (16-63)"""
-    # W[i] = sigma1(W[i-2]) + W[i-7] + sigma0(W[i-15]) + W[i-16]
-    # sigma0(x) = ROTR(x,7) ^ ROTR(x,18) ^ SHR(x,3)
-    # sigma1(x) = ROTR(x,17) ^ ROTR(x,19) ^ SHR(x,10)
-    
+def generate_sigma1(i):
+    """sigma1(W[i-2]) into %s1, for the extension of W[i]"""
     w_i_2 = f"%w{(i-2) % 16}"
-    w_i_7 = f"%w{(i-7) % 16}"
-    w_i_15 = f"%w{(i-15) % 16}"
-    w_i_16 = f"%w{(i-16) % 16}"
-    w_i = f"%w{i % 16}"
-    
-    code = f"""    // Extend W[{i}]
-    // Save W[{i-16}] before we overwrite it (if w_i == w_i_16)
-    mov.u32         %r70, {w_i_16};
-    // sigma1(W[{i-2}])
+    return f"""    // sigma1(W[{i-2}])
     shr.u32         %r50, {w_i_2}, 17;
     shl.b32         %r51, {w_i_2}, 15;
     or.b32          %r52, %r50, %r51;
@@ -92,7 +130,12 @@ def generate_message_schedule_extension(i):
     shr.u32         %r56, {w_i_2}, 10;
     xor.b32         %s1, %r52, %r55;
     xor.b32         %s1, %s1, %r56;
-    // sigma0(W[{i-15}])
+"""
+
+def generate_sigma0(i):
+    """sigma0(W[i-15]) into %s0, for the extension of W[i]"""
+    w_i_15 = f"%w{(i-15) % 16}"
+    return f"""    // sigma0(W[{i-15}])
     shr.u32         %r57, {w_i_15}, 7;
     shl.b32         %r58, {w_i_15}, 25;
     or.b32          %r59, %r57, %r58;
@@ -102,7 +145,22 @@ def generate_message_schedule_extension(i):
     shr.u32         %r63, {w_i_15}, 3;
     xor.b32         %s0, %r59, %r62;
     xor.b32         %s0, %s0, %r63;
-    // W[{i}] = sigma1 + W[{i-7}] + sigma0 + W[{i-16}]
+"""
+
+def generate_message_schedule_extension(i):
+    """Generate code to extend message schedule for round i (16-63)"""
+    # W[i] = sigma1(W[i-2]) + W[i-7] + sigma0(W[i-15]) + W[i-16]
+    # sigma0(x) = ROTR(x,7) ^ ROTR(x,18) ^ SHR(x,3)
+    # sigma1(x) = ROTR(x,17) ^ ROTR(x,19) ^ SHR(x,10)
+    
+    w_i_7 = f"%w{(i-7) % 16}"
+    w_i_16 = f"%w{(i-16) % 16}"
+    w_i = f"%w{i % 16}"
+    
+    code = f"""    // Extend W[{i}]
+    // Save W[{i-16}] before we overwrite it (if w_i == w_i_16)
+    mov.u32         %r70, {w_i_16};
+""" + generate_sigma1(i) + generate_sigma0(i) + f"""    // W[{i}] = sigma1 + W[{i-7}] + sigma0 + W[{i-16}]
     add.u32         {w_i}, %s1, {w_i_7};
     add.u32         {w_i}, {w_i}, %s0;
     add.u32         {w_i}, {w_i}, %r70;
@@ -112,61 +170,362 @@ def generate_message_schedule_extension(i):
     
     return code
 
-def generate_all_rounds():
-    """Generate all 64 SHA256 rounds"""
+def generate_folded_extension(i, known):
+    """Extend W[i] with the compile-time constant terms folded
+
+    known is the shape's schedule (see sha256_shapes.known_schedule), None
+    for words that depend on data. The constant terms become one immediate,
+    left out when it is zero; only the data terms are computed.
+    """
+    w_i = f"%w{i % 16}"
+    code = f"""    // Extend W[{i}] (constant terms folded)
+"""
+    const = 0
+    terms = []
+    if known[i - 2] is None:
+        code += generate_sigma1(i)
+        terms.append("%s1")
+    else:
+        const += sigma1(known[i - 2])
+    if known[i - 7] is None:
+        terms.append(f"%w{(i-7) % 16}")
+    else:
+        const += known[i - 7]
+    if known[i - 15] is None:
+        code += generate_sigma0(i)
+        terms.append("%s0")
+    else:
+        const += sigma0(known[i - 15])
+    if known[i - 16] is None:
+        # W[i - 16] is in W[i]'s register already
+        acc = w_i
+    else:
+        const += known[i - 16]
+        acc = terms.pop(0)
+    const &= 0xffffffff
+    if not terms and not const:
+        return code + f"""    mov.u32         {w_i}, {acc};
+"""
+    for term in terms:
+        code += f"""    add.u32         {w_i}, {acc}, {term};
+"""
+        acc = w_i
+    if const:
+        code += f"""    add.u32         {w_i}, {acc}, 0x{const:08x};
+"""
+    return code
+
+def generate_all_rounds(first=0, end=64, known=None):
+    """Generate SHA256 rounds first..end-1 (all 64 by default)
+    
+    known, if given, is the block's schedule with the compile-time constant
+    words filled in (sha256_shapes.known_schedule): a round with a constant
+    W[t] adds K[t] + W[t] as one immediate, and extensions fold their
+    constant terms. The registers of constant words are never read.
+    """
+    if known is None:
+        known = [None] * 64
     rounds = []
     
     # Rounds 0-15: use W[0-15] directly
-    for i in range(16):
+    for i in range(first, min(end, 16)):
+        if known[i] is not None:
+            rounds.append(generate_round(i, None, kw=(SHA256_K[i] + known[i]) & 0xffffffff))
+            continue
         w_expr = f"mov.u32         %w_val, %w{i};"
         rounds.append(generate_round(i, w_expr))
     
     # Rounds 16-63: extend message schedule
-    for i in range(16, 64):
+    for i in range(max(first, 16), end):
+        if known[i] is not None:
+            rounds.append(generate_round(i, None, kw=(SHA256_K[i] + known[i]) & 0xffffffff))
+            continue
         # First extend the message schedule
-        extend_code = generate_message_schedule_extension(i)
+        if any(known[t] is not None for t in (i - 2, i - 7, i - 15, i - 16)):
+            extend_code = generate_folded_extension(i, known)
+        else:
+            extend_code = generate_message_schedule_extension(i)
         # Then use the extended value
         w_expr = f"mov.u32         %w_val, %w{i % 16};"
         rounds.append(extend_code + generate_round(i, w_expr))
     
     return "\n".join(rounds)
 
-def generate_full_kernel():
-    """Generate the complete SHA256 PTX kernel"""
+def prefix_varying(counter_positions):
+    """Split the message schedule of a prefix kernel into fixed and varying parts
     
-    header = """// SHA256 PTX Kernel - Auto-generated with all 64 rounds
-// Generated by generate_sha256_ptx.py
+    Returns (rounds, varying): rounds is the number of leading message words
+    without a counter byte, i.e. the rounds the host runs once per batch, and
+    varying is the set of t whose W[t] depends on a counter byte.
+    """
+    words = {pos // 4 for pos in counter_positions}
+    varying = set(words)
+    for t in range(16, 64):
+        if varying & {t - 2, t - 7, t - 15, t - 16}:
+            varying.add(t)
+    return min(words), varying
 
-.version 8.7
-.target sm_120
-.address_size 64
+def generate_prefix_extension(i, varying):
+    """Extend W[i] of a prefix kernel: the host passes the sum of the terms
+    that only depend on fixed words, the device adds the varying ones"""
+    w_i = f"%w{i % 16}"
+    code = f"""    // Extend W[{i}] = fixed part + varying terms
+    ld.param.u32    %r70, [param_prefix+{PREFIX_SCHEDULE_OFFSET + i * 4}];
+"""
+    if i - 2 in varying:
+        code += generate_sigma1(i) + """    add.u32         %r70, %r70, %s1;
+"""
+    if i - 7 in varying:
+        code += f"""    add.u32         %r70, %r70, %w{(i-7) % 16};
+"""
+    if i - 15 in varying:
+        code += generate_sigma0(i) + """    add.u32         %r70, %r70, %s0;
+"""
+    if i - 16 in varying:
+        code += f"""    add.u32         %r70, %r70, {w_i};
+"""
+    code += f"""    mov.u32         {w_i}, %r70;
+"""
+    return code
 
-// SHA256 K constants
-.const .align 4 .b32 K[64] = {
-    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5,
-    0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
-    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
-    0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
-    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc,
-    0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
-    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7,
-    0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
-    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
-    0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
-    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3,
-    0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
-    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5,
-    0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
-    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
-    0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
-};
+def generate_prefix_rounds(counter_positions, first=0, end=64):
+    """Rounds first..end-1 of a prefix kernel, skipping the host-side ones.
+    Fixed schedule words are read straight from the parameter table."""
+    prefix_rounds, varying = prefix_varying(counter_positions)
+    rounds = []
+    for i in range(max(first, prefix_rounds), end):
+        if i not in varying:
+            w_expr = f"ld.param.u32    %w_val, [param_prefix+{PREFIX_SCHEDULE_OFFSET + i * 4}];"
+            rounds.append(generate_round(i, w_expr))
+            continue
+        extend_code = generate_prefix_extension(i, varying) if i >= 16 else ""
+        w_expr = f"mov.u32         %w_val, %w{i % 16};"
+        rounds.append(extend_code + generate_round(i, w_expr))
+    return "\n".join(rounds)
+
+# Padding words of the 33-byte key block, and its schedule with them
+# propagated
+KEY33_BLOCK = SHAPES["key33"].blocks[0]
+KEY33_SCHEDULE = known_schedule(KEY33_BLOCK)
+
+# K + W for the padding block of a 64-byte message
+PAD64_KW = constant_kw(SHAPES["node64"].blocks[1])
+
+def generate_pad64_rounds(first=0, end=64):
+    """Rounds first..end-1 of the second block of a 64-byte message, which
+    is pure padding: every K + W is a compile-time immediate. Starting at
+    round 0 first folds the data block into %h0..%h7 and restarts from it."""
+    code = ""
+    if first == 0:
+        code += """
+    // Second block: padding only (0x80, zeros, length 512)
+    add.u32         %h0, %h0, %a;
+    add.u32         %h1, %h1, %b;
+    add.u32         %h2, %h2, %c;
+    add.u32         %h3, %h3, %d;
+    add.u32         %h4, %h4, %e;
+    add.u32         %h5, %h5, %f;
+    add.u32         %h6, %h6, %g;
+    add.u32         %h7, %h7, %h;
+    mov.u32         %a, %h0;
+    mov.u32         %b, %h1;
+    mov.u32         %c, %h2;
+    mov.u32         %d, %h3;
+    mov.u32         %e, %h4;
+    mov.u32         %f, %h5;
+    mov.u32         %g, %h6;
+    mov.u32         %h, %h7;
+"""
+    return code + "\n".join(generate_round(i, None, kw=PAD64_KW[i]) for i in range(first, end))
+
+def generate_rounds(input_mode, counter_positions, first=0, end=64):
+    """Rounds first..end-1 of the last compression for an input mode"""
+    if input_mode == "prefix":
+        return generate_prefix_rounds(counter_positions, first, end)
+    if input_mode == "node64":
+        data_block = generate_all_rounds() if first == 0 else ""
+        return data_block + generate_pad64_rounds(first, end)
+    return generate_all_rounds(first, end, KEY33_SCHEDULE)
+
+def generate_filter_test(block_word, bit_word, guard):
+    """Test two digest words against the target filter, setting %p1
+
+    The filter is a split-block Bloom filter (see include/target_filter.h):
+    block_word & mask picks a 256-bit block, and (bit_word * salt[i]) >> 27
+    picks the bit tested in block word i. guard, if given, must also hold.
+    """
+    code = """    and.b32         %r80, {block_word}, %filter_mask;
+    mul.wide.u32    %rd3, %r80, 32;
+    add.u64         %rd3, %filter_base, %rd3;
+    ld.global.v4.u32    {{%r81, %r82, %r83, %r84}}, [%rd3];
+    ld.global.v4.u32    {{%r85, %r86, %r87, %r88}}, [%rd3+16];
+    mov.u32         %r90, 1;
+""".format(block_word=block_word)
+    for i, salt in enumerate(FILTER_SALT):
+        code += f"""    mul.lo.u32      %r89, {bit_word}, 0x{salt:08x};
+    shr.u32         %r89, %r89, 27;
+    shr.u32         %r{81 + i}, %r{81 + i}, %r89;
+    and.b32         %r90, %r90, %r{81 + i};
+"""
+    code += """    setp.ne.u32     %p1, %r90, 0;
+"""
+    if guard:
+        code += f"""    and.pred        %p1, %p1, {guard};
+"""
+    return code
+
+def generate_hit_append(key_index, with_digest):
+    """Append a hit for key_index if %p1 is set
+
+    Candidates reserve a slot in the hit list with an atomic add on the hit
+    count; the count keeps growing past max_hits so the host can detect
+    overflow. Records are the key index alone, or with_digest the index
+    followed by the native-endian digest words H0..H7 (36 bytes).
+    """
+    record_size = 36 if with_digest else 4
+    code = f"""    // Append {"{key index, H0..H7}" if with_digest else "the key index"} to the hit list
+    mov.u32         %r91, 0xffffffff;
+    @%p1 atom.global.add.u32    %r91, [%hit_count_ptr], 1;
+    setp.lt.u32     %p2, %r91, %max_hits;
+    mul.wide.u32    %rd4, %r91, {record_size};
+    add.u64         %rd4, %hits_base, %rd4;
+    @%p2 st.global.u32  [%rd4], {key_index};
+"""
+    if with_digest:
+        for i in range(8):
+            code += f"""    @%p2 st.global.u32  [%rd4+{4 + i * 4}], %h{i};
+"""
+    return code
+
+def generate_filter_probe(key_index, guard):
+    """Test the finished digest against the target filter and append hits"""
+    code = """    // Probe the target filter: block = H0 & mask, bit i from H1 * salt[i] >> 27
+"""
+    code += generate_filter_test("%h0", "%h1", guard)
+    code += generate_hit_append(key_index, with_digest=False)
+    return code
+
+def generate_early_reject(guard, chained=False):
+    """Match mode: test the filter after round 60, leaving the verdict in %p1
+
+    After round 60 the last three rounds only shift e into f, g, h and a
+    into b, c, d, so the final H7 = IV7 + e and H3 = IV3 + a are already
+    known. Match filters are keyed on them (TARGET_FILTER_KEY_H7H3).
+    chained: the last compression does not start from the IV (multi-block
+    inputs); add the chaining value held in %h7 / %h3 instead.
+    """
+    if chained:
+        code = """
+    // Early reject: H7 = h7 + e and H3 = h3 + a are final after round 60
+    add.u32         %r92, %e, %h7;
+    add.u32         %r93, %a, %h3;
+"""
+    else:
+        code = """
+    // Early reject: H7 = IV7 + e and H3 = IV3 + a are final after round 60
+    add.u32         %r92, %e, 0x5be0cd19;
+    add.u32         %r93, %a, 0xa54ff53a;
+"""
+    code += generate_filter_test("%r92", "%r93", guard)
+    return code
+
+def generate_output_store(output_layout, key_index="%thread_id", guard=None):
+    """Generate the digest store for the requested output layout
+
+    bytes: 32 big-endian bytes per hash (the SHA256 digest as specified)
+    words: eight native-endian 32-bit words per hash, as two 128-bit stores
+    filter: no digest; the key index is appended to a hit list when the
+    digest passes the target filter
+    match: the hit list gets the key index and digest of each candidate
+    (the filter test itself runs early, see generate_early_reject)
+    
+    guard, if given, is a predicate register that must be true to write.
+    """
+    if output_layout == "filter":
+        return generate_filter_probe(key_index, guard)
+    if output_layout == "match":
+        return generate_hit_append(key_index, with_digest=True)
+    
+    if output_layout == "words":
+        code = """    // Store output as native-endian words (two 128-bit stores)
+    st.global.v4.u32    [%output_ptr], {%h0, %h1, %h2, %h3};
+    st.global.v4.u32    [%output_ptr+16], {%h4, %h5, %h6, %h7};
+"""
+        return guard_stores(code, guard)
+
+    code = """    // Store output as big-endian bytes
+"""
+    for i in range(8):
+        offset = i * 4
+        code += f"""    shr.u32         %r40, %h{i}, 24;
+    st.global.u8    [%output_ptr+{offset}], %r40;
+    shr.u32         %r41, %h{i}, 16;
+    st.global.u8    [%output_ptr+{offset+1}], %r41;
+    shr.u32         %r42, %h{i}, 8;
+    st.global.u8    [%output_ptr+{offset+2}], %r42;
+    st.global.u8    [%output_ptr+{offset+3}], %h{i};
+"""
+    return guard_stores(code, guard)
 
+def guard_stores(code, guard):
+    """Predicate every store in code on guard"""
+    if not guard:
+        return code
+    return "\n".join(f"    @{guard} " + line.strip() if line.strip().startswith("st.") else line
+                     for line in code.split("\n"))
+
+def generate_params(input_mode, output_layout):
+    """Kernel parameter list for an input mode / output layout pair"""
+    if input_mode == "counter":
+        params = ["    .param .align 4 .b8 param_base[36]",
+                  "    .param .u64 param_start"]
+    elif input_mode == "prefix":
+        params = [f"    .param .align 4 .b8 param_prefix[{PREFIX_PARAM_BYTES}]",
+                  "    .param .u64 param_start"]
+    elif input_mode == "arena":
+        params = ["    .param .u64 param_input",
+                  "    .param .u64 param_entries"]
+    else:
+        params = ["    .param .u64 param_input"]
+    if output_layout in HIT_LIST_LAYOUTS:
+        params += ["    .param .u64 param_filter",
+                   "    .param .u32 param_filter_mask",
+                   "    .param .u64 param_hits",
+                   "    .param .u64 param_hit_count",
+                   "    .param .u32 param_max_hits"]
+    else:
+        params += ["    .param .u64 param_output"]
+    params += ["    .param .u32 param_num_keys"]
+    return ",\n".join(params)
+
+# Filter-mode registers, loaded once in the prologue
+FILTER_REG_DECLS = """    .reg .b64   %filter_base, %hits_base, %hit_count_ptr;
+    .reg .b32   %filter_mask, %max_hits;
+"""
+
+FILTER_PARAM_LOADS = """    ld.param.u64    %filter_base, [param_filter];
+    ld.param.u32    %filter_mask, [param_filter_mask];
+    ld.param.u64    %hits_base, [param_hits];
+    ld.param.u64    %hit_count_ptr, [param_hit_count];
+    ld.param.u32    %max_hits, [param_max_hits];
+"""
+
+FILTER_CVTA = """    cvta.to.global.u64  %filter_base, %filter_base;
+    cvta.to.global.u64  %hits_base, %hits_base;
+    cvta.to.global.u64  %hit_count_ptr, %hit_count_ptr;
+"""
+
+def generate_entry(input_mode, output_layout):
+    """Generate the kernel entry point, register declarations and prologue"""
+    
+    params = generate_params(input_mode, output_layout)
+    
+    code = f"""
 .visible .entry sha256_kernel(
-    .param .u64 param_input,
-    .param .u64 param_output,
-    .param .u32 param_num_keys
+{params}
 )
-{
+"""
+    code += """{
     .reg .b32   %r<100>;
     .reg .b64   %rd<10>;
     .reg .pred  %p<10>;
@@ -174,7 +533,18 @@ def generate_full_kernel():
     .reg .b32   %thread_id;
     .reg .b64   %input_ptr, %output_ptr;
     .reg .b64   %input_base, %output_base;
-    
+"""
+    if input_mode in ENUMERATED_INPUTS:
+        code += """    .reg .b64   %counter;
+    .reg .b32   %counter_lo, %counter_hi;
+"""
+    if input_mode == "arena":
+        code += """    .reg .b64   %entry_ptr;
+    .reg .b32   %msg_len, %msg_index, %msg_rem, %block_pos, %end_pos;
+"""
+    if output_layout in HIT_LIST_LAYOUTS:
+        code += FILTER_REG_DECLS
+    code += """    
     // SHA256 state
     .reg .b32   %a, %b, %c, %d, %e, %f, %g, %h;
     .reg .b32   %h0, %h1, %h2, %h3, %h4, %h5, %h6, %h7;
@@ -196,24 +566,55 @@ def generate_full_kernel():
     mad.lo.s32  %thread_id, %r0, %r1, %r2;
     
     // Load parameters
-    ld.param.u64    %input_base, [param_input];
-    ld.param.u64    %output_base, [param_output];
-    ld.param.u32    %r3, [param_num_keys];
+"""
+    if input_mode not in ENUMERATED_INPUTS:
+        code += """    ld.param.u64    %input_base, [param_input];
+"""
+    if output_layout in HIT_LIST_LAYOUTS:
+        code += FILTER_PARAM_LOADS
+    else:
+        code += """    ld.param.u64    %output_base, [param_output];
+"""
+    code += """    ld.param.u32    %r3, [param_num_keys];
     
     // Bounds check
     setp.ge.u32     %p0, %thread_id, %r3;
     @%p0 bra        END;
     
     // Convert to global addresses
-    cvta.to.global.u64  %input_base, %input_base;
-    cvta.to.global.u64  %output_base, %output_base;
-    
+"""
+    if input_mode not in ENUMERATED_INPUTS:
+        code += """    cvta.to.global.u64  %input_base, %input_base;
+"""
+    if output_layout in HIT_LIST_LAYOUTS:
+        code += FILTER_CVTA
+    else:
+        code += """    cvta.to.global.u64  %output_base, %output_base;
+"""
+    code += """    
     // Calculate pointers
-    mul.wide.u32    %rd0, %thread_id, 33;
+"""
+    if input_mode in INPUT_RECORD_BYTES:
+        code += f"""    mul.wide.u32    %rd0, %thread_id, {INPUT_RECORD_BYTES[input_mode]};
     add.u64         %input_ptr, %input_base, %rd0;
-    mul.wide.u32    %rd1, %thread_id, 32;
+"""
+    if input_mode == "arena":
+        code += f"""    // Message entry: arena offset, length, digest slot
+    ld.param.u64    %entry_ptr, [param_entries];
+    cvta.to.global.u64  %entry_ptr, %entry_ptr;
+    mul.wide.u32    %rd0, %thread_id, {ARENA_ENTRY_BYTES};
+    add.u64         %entry_ptr, %entry_ptr, %rd0;
+    ld.global.u64   %rd2, [%entry_ptr];
+    ld.global.v2.u32    {{%msg_len, %msg_index}}, [%entry_ptr+8];
+    add.u64         %input_ptr, %input_base, %rd2;
+    mul.wide.u32    %rd1, %msg_index, 32;
     add.u64         %output_ptr, %output_base, %rd1;
-    
+"""
+    elif output_layout not in HIT_LIST_LAYOUTS:
+        code += """    mul.wide.u32    %rd1, %thread_id, 32;
+    add.u64         %output_ptr, %output_base, %rd1;
+"""
+    code += """    
     // Initialize hash values
     mov.u32     %h0, 0x6a09e667;
     mov.u32     %h1, 0xbb67ae85;
@@ -224,14 +625,11 @@ def generate_full_kernel():
     mov.u32     %h6, 0x1f83d9ab;
     mov.u32     %h7, 0x5be0cd19;
 """
-    
-    # Load input section (33 bytes -> 16 words with padding)
-    load_input = """
-    // Load 33-byte input as big-endian words
-"""
-    for i in range(8):
-        offset = i * 4
-        load_input += f"""    ld.global.u8    %r4, [%input_ptr+{offset}];
+    return code
+
+def generate_word_load(i, offset):
+    """Load W[i] from four input bytes at %input_ptr+offset (big-endian)"""
+    return f"""    ld.global.u8    %r4, [%input_ptr+{offset}];
     ld.global.u8    %r5, [%input_ptr+{offset+1}];
     ld.global.u8    %r6, [%input_ptr+{offset+2}];
     ld.global.u8    %r7, [%input_ptr+{offset+3}];
@@ -242,19 +640,162 @@ def generate_full_kernel():
     or.b32          %w{i}, %w{i}, %r6;
     or.b32          %w{i}, %w{i}, %r7;
 """
+
+def generate_arena_blocks():
+    """Block loop of an arena kernel: hash the %msg_len bytes at %input_ptr
+    into %h0..%h7, padding included
+
+    Whole blocks load like a 33-byte key. The block holding the end of the
+    message (and a padding-only block after it) is built byte by byte:
+    %msg_rem is the bytes left from the block start plus 64, which stays
+    unsigned in a padding-only block, so byte k is data while
+    %msg_rem > k + 64 and the 0x80 pad when it equals k + 64.
+    """
+    code = """
+    // Padded length: whole blocks of (length + 9) bytes
+    add.u32         %end_pos, %msg_len, 72;
+    and.b32         %end_pos, %end_pos, 0xffffffc0;
+    mov.u32         %block_pos, 0;
+
+ARENA_BLOCK:
+    mov.u32         %a, %h0;
+    mov.u32         %b, %h1;
+    mov.u32         %c, %h2;
+    mov.u32         %d, %h3;
+    mov.u32         %e, %h4;
+    mov.u32         %f, %h5;
+    mov.u32         %g, %h6;
+    mov.u32         %h, %h7;
+    add.u32         %r6, %block_pos, 64;
+    setp.gt.u32     %p1, %r6, %msg_len;
+    @%p1 bra        ARENA_TAIL;
+
+    // Whole message block
+"""
+    for i in range(16):
+        code += generate_word_load(i, i * 4)
+    code += """    bra             ARENA_ROUNDS;
+
+ARENA_TAIL:
+    // End of the message: data bytes, the 0x80 pad, then zeros
+    add.u32         %msg_rem, %msg_len, 64;
+    sub.u32         %msg_rem, %msg_rem, %block_pos;
+"""
+    for k in range(64):
+        i, j = k // 4, k % 4
+        code += f"""    setp.gt.u32     %p1, %msg_rem, {k + 64};
+    setp.eq.u32     %p2, %msg_rem, {k + 64};
+    mov.u32         %r4, 0;
+    @%p1 ld.global.u8    %r4, [%input_ptr+{k}];
+    @%p2 mov.u32    %r4, 0x80;
+"""
+        if j == 0:
+            code += f"""    shl.b32         %w{i}, %r4, 24;
+"""
+        else:
+            code += f"""    bfi.b32         %w{i}, %r4, %w{i}, {24 - 8 * j}, 8;
+"""
+    code += """    // Last block: the message length in bits
+    add.u32         %r6, %block_pos, 64;
+    setp.eq.u32     %p3, %r6, %end_pos;
+    @%p3 shr.u32    %w14, %msg_len, 29;
+    @%p3 shl.b32    %w15, %msg_len, 3;
+
+ARENA_ROUNDS:
+"""
+    code += generate_all_rounds()
+    code += """
+    // Chain into the next block
+    add.u32         %h0, %h0, %a;
+    add.u32         %h1, %h1, %b;
+    add.u32         %h2, %h2, %c;
+    add.u32         %h3, %h3, %d;
+    add.u32         %h4, %h4, %e;
+    add.u32         %h5, %h5, %f;
+    add.u32         %h6, %h6, %g;
+    add.u32         %h7, %h7, %h;
+    add.u32         %block_pos, %block_pos, 64;
+    add.u64         %input_ptr, %input_ptr, 64;
+    setp.lt.u32     %p0, %block_pos, %end_pos;
+    @%p0 bra        ARENA_BLOCK;
     
-    # Last byte + padding
-    load_input += """    ld.global.u8    %r4, [%input_ptr+32];
+"""
+    return code
+
+def generate_input_load(input_mode, counter_positions, key_index="%thread_id"):
+    """Generate the message words of the input: W[0..8] of the 33-byte
+    message (W[9..15] are padding constants folded into the rounds), or the
+    16 data words of a 64-byte node"""
+    
+    if input_mode in ENUMERATED_INPUTS:
+        # Base record words come in as a parameter (big-endian, byte 33 already
+        # holding the 0x80 pad); the key counter overwrites the chosen bytes.
+        # Prefix kernels only load the words holding counter bytes: the rest
+        # is folded into the precomputed rounds and schedule sums.
+        load_input = f"""
+    // Build 33-byte input from the base record and the key counter
+    ld.param.u64    %counter, [param_start];
+    cvt.u64.u32     %rd2, {key_index};
+    add.u64         %counter, %counter, %rd2;
+    cvt.u32.u64     %counter_lo, %counter;
+    shr.u64         %rd2, %counter, 32;
+    cvt.u32.u64     %counter_hi, %rd2;
+"""
+        if input_mode == "prefix":
+            for i in sorted({pos // 4 for pos in counter_positions}):
+                load_input += f"""    ld.param.u32    %w{i}, [param_prefix+{PREFIX_SCHEDULE_OFFSET + i * 4}];
+"""
+        else:
+            for i in range(9):
+                load_input += f"""    ld.param.u32    %w{i}, [param_base+{i * 4}];
+"""
+        for i, pos in enumerate(counter_positions):
+            half = "%counter_lo" if i < 4 else "%counter_hi"
+            word = pos // 4
+            shift = (3 - pos % 4) * 8
+            load_input += f"""    // Counter byte {i} -> input byte {pos}
+    bfe.u32         %r4, {half}, {(i % 4) * 8}, 8;
+    bfi.b32         %w{word}, %r4, %w{word}, {shift}, 8;
+"""
+    elif input_mode == "node64":
+        # Two child digests as native-endian words: the data block as is
+        load_input = """
+    // Load the 64-byte node (left and right child digest words)
+    ld.global.v4.u32    {%w0, %w1, %w2, %w3}, [%input_ptr];
+    ld.global.v4.u32    {%w4, %w5, %w6, %w7}, [%input_ptr+16];
+    ld.global.v4.u32    {%w8, %w9, %w10, %w11}, [%input_ptr+32];
+    ld.global.v4.u32    {%w12, %w13, %w14, %w15}, [%input_ptr+48];
+"""
+    else:
+        # Load input section (33 bytes -> 16 words with padding)
+        load_input = """
+    // Load 33-byte input as big-endian words
+"""
+        for i in range(8):
+            load_input += generate_word_load(i, i * 4)
+        
+        # Last byte + padding
+        load_input += f"""    ld.global.u8    %r4, [%input_ptr+32];
     shl.b32         %r4, %r4, 24;
-    or.b32          %w8, %r4, 0x00800000;
-    mov.u32         %w9, 0;
-    mov.u32         %w10, 0;
-    mov.u32         %w11, 0;
-    mov.u32         %w12, 0;
-    mov.u32         %w13, 0;
-    mov.u32         %w14, 0;
-    mov.u32         %w15, 0x00000108;
+    or.b32          %w8, %r4, 0x{KEY33_BLOCK[8].bits:08x};
+"""
+    
+    if input_mode == "prefix":
+        load_input += """
+    // Working variables after the rounds run on the host
+    ld.param.u32    %a, [param_prefix+0];
+    ld.param.u32    %b, [param_prefix+4];
+    ld.param.u32    %c, [param_prefix+8];
+    ld.param.u32    %d, [param_prefix+12];
+    ld.param.u32    %e, [param_prefix+16];
+    ld.param.u32    %f, [param_prefix+20];
+    ld.param.u32    %g, [param_prefix+24];
+    ld.param.u32    %h, [param_prefix+28];
+"""
+        return load_input
     
+    # W[9..15] are padding constants, folded into the rounds (KEY33_SCHEDULE)
+    load_input += """    
     // Initialize working variables
     mov.u32         %a, %h0;
     mov.u32         %b, %h1;
@@ -265,9 +806,267 @@ def generate_full_kernel():
     mov.u32         %g, %h6;
     mov.u32         %h, %h7;
 """
+    return load_input
+
+# Registers shared by all hashes of a thread; every other register in the
+# per-hash code gets a _<n> suffix so interleaved hashes never collide
+SHARED_REGS = {"%thread_id", "%num_threads", "%key_base", "%num_keys", "%last_key",
+               "%input_base", "%output_base",
+               "%filter_base", "%filter_mask", "%hits_base", "%hit_count_ptr", "%max_hits"}
+
+def suffix_registers(code, n):
+    """Rename the per-hash registers in code for hash n"""
+    def rename(match):
+        reg = match.group(0)
+        return reg if reg in SHARED_REGS else f"{reg}_{n}"
+    return re.sub(r"%[A-Za-z_][A-Za-z0-9_]*", rename, code)
+
+def interleave(codes):
+    """Merge per-hash code line by line (the hashes have identical structure).
+    Comments and blank lines are kept once, from the first hash."""
+    merged = []
+    for lines in zip(*(code.split("\n") for code in codes)):
+        merged.append(lines[0])
+        for line in lines[1:]:
+            stripped = line.strip()
+            if stripped and not stripped.startswith("//"):
+                merged.append(line)
+    return "\n".join(merged)
+
+def declare_registers(code):
+    """Declarations for every register used by per-hash code, typed by name"""
+    def natural(reg):
+        name, n = reg.rsplit("_", 1)
+        return (int(n), [int(t) if t.isdigit() else t for t in re.split(r"(\d+)", name)])
+    regs = sorted(set(re.findall(r"%[A-Za-z_][A-Za-z0-9_]*_\d+\b", code)), key=natural)
+    b64 = re.compile(r"^%(rd\d+|input_ptr|output_ptr|counter)_\d+$")
+    pred = re.compile(r"^%(p\d+|store)_\d+$")
+    groups = {".pred": [], ".b64": [], ".b32": []}
+    for reg in regs:
+        if pred.match(reg):
+            groups[".pred"].append(reg)
+        elif b64.match(reg):
+            groups[".b64"].append(reg)
+        else:
+            groups[".b32"].append(reg)
+    code = ""
+    for reg_type, names in groups.items():
+        for i in range(0, len(names), 8):
+            code += f"    .reg {reg_type:<6}{', '.join(names[i:i + 8])};\n"
+    return code
+
+def generate_strided_body(input_mode, output_layout, counter_positions, ilp):
+    """Generate a grid-stride kernel body hashing ilp keys per iteration
+    
+    Thread t of T resident threads starts at key t; hash n of an iteration
+    takes key (base + n * T) and the base advances by ilp * T, so one launch
+    of any size covers the whole batch and stores stay coalesced. A hash whose
+    key is past the end is computed on the last key and its store is skipped,
+    which keeps the interleaved code free of branches.
+    """
+    
+    params = generate_params(input_mode, output_layout)
     
-    # All 64 rounds
-    rounds = generate_all_rounds()
+    # Per-hash setup: key index, store predicate, pointers, initial state
+    setup = """
+    // Key index for this hash; past-the-end keys recompute the last key
+    mad.lo.s32      %key, %num_threads, {n}, %key_base;
+    setp.lt.u32     %store, %key, %num_keys;
+    min.u32         %key, %key, %last_key;
+"""
+    if input_mode not in ENUMERATED_INPUTS:
+        setup += f"""    mul.wide.u32    %rd0, %key, {INPUT_RECORD_BYTES[input_mode]};
+    add.u64         %input_ptr, %input_base, %rd0;
+"""
+    if output_layout not in HIT_LIST_LAYOUTS:
+        setup += """    mul.wide.u32    %rd1, %key, 32;
+    add.u64         %output_ptr, %output_base, %rd1;
+"""
+    setup += """    mov.u32         %h0, 0x6a09e667;
+    mov.u32         %h1, 0xbb67ae85;
+    mov.u32         %h2, 0x3c6ef372;
+    mov.u32         %h3, 0xa54ff53a;
+    mov.u32         %h4, 0x510e527f;
+    mov.u32         %h5, 0x9b05688c;
+    mov.u32         %h6, 0x1f83d9ab;
+    mov.u32         %h7, 0x5be0cd19;
+"""
+    
+    store = generate_output_store(output_layout, key_index="%key", guard="%store")
+    finish = """
+    // Add compressed hash to initial values
+    add.u32         %h0, %h0, %a;
+    add.u32         %h1, %h1, %b;
+    add.u32         %h2, %h2, %c;
+    add.u32         %h3, %h3, %d;
+    add.u32         %h4, %h4, %e;
+    add.u32         %h5, %h5, %f;
+    add.u32         %h6, %h6, %g;
+    add.u32         %h7, %h7, %h;
+    
+""" + store
+    
+    if output_layout == "match":
+        # Rounds 0-60 and the filter test for every hash; the rest only runs
+        # when at least one hash of the iteration is a candidate
+        first_part, second_part = [], []
+        for n in range(ilp):
+            code = setup.replace("{n}", str(n))
+            code += generate_input_load(input_mode, counter_positions, key_index="%key")
+            code += generate_rounds(input_mode, counter_positions, 0, 61)
+            code += generate_early_reject(guard="%store", chained=input_mode == "node64")
+            first_part.append(suffix_registers(code, n))
+            second_part.append(suffix_registers(generate_rounds(input_mode, counter_positions, 61, 64) + finish, n))
+        candidates = " | ".join(f"%p1_{n}" for n in range(ilp))
+        skip = f"""
+    // Skip rounds 61-63 unless a hash is a candidate ({candidates})
+"""
+        if ilp == 1:
+            skip += """    @!%p1_0 bra     NEXT;
+"""
+        else:
+            skip += """    or.pred         %p1, %p1_0, %p1_1;
+"""
+            for n in range(2, ilp):
+                skip += f"""    or.pred         %p1, %p1, %p1_{n};
+"""
+            skip += """    @!%p1 bra       NEXT;
+"""
+        body = interleave(first_part) + skip + interleave(second_part) + """
+NEXT:"""
+    else:
+        per_hash = []
+        for n in range(ilp):
+            code = setup.replace("{n}", str(n))
+            code += generate_input_load(input_mode, counter_positions, key_index="%key")
+            code += generate_rounds(input_mode, counter_positions)
+            code += finish
+            per_hash.append(suffix_registers(code, n))
+        body = interleave(per_hash)
+    
+    code = f"""
+.visible .entry sha256_kernel(
+{params}
+)
+{{
+    .reg .b32   %r<10>;
+    .reg .pred  %p<2>;
+    
+    .reg .b32   %thread_id, %num_threads, %key_base, %num_keys, %last_key;
+    .reg .b64   %input_base, %output_base;
+{FILTER_REG_DECLS if output_layout in HIT_LIST_LAYOUTS else ""}    
+    // Per-hash registers (suffix = hash within the thread's iteration)
+{declare_registers(body)}    
+    // Thread ID and resident thread count
+    mov.u32     %r0, %ctaid.x;
+    mov.u32     %r1, %ntid.x;
+    mov.u32     %r2, %tid.x;
+    mad.lo.s32  %thread_id, %r0, %r1, %r2;
+    mov.u32     %r3, %nctaid.x;
+    mul.lo.s32  %num_threads, %r3, %r1;
+    
+    // Load parameters
+"""
+    if input_mode not in ENUMERATED_INPUTS:
+        code += """    ld.param.u64    %input_base, [param_input];
+    cvta.to.global.u64  %input_base, %input_base;
+"""
+    if output_layout in HIT_LIST_LAYOUTS:
+        code += FILTER_PARAM_LOADS + FILTER_CVTA
+    else:
+        code += """    ld.param.u64    %output_base, [param_output];
+    cvta.to.global.u64  %output_base, %output_base;
+"""
+    code += f"""    ld.param.u32    %num_keys, [param_num_keys];
+    sub.u32         %last_key, %num_keys, 1;
+    mov.u32         %key_base, %thread_id;
+    
+LOOP:
+    setp.ge.u32     %p0, %key_base, %num_keys;
+    @%p0 bra        END;
+{body}
+    // Next iteration: {ilp} keys per thread
+    mad.lo.s32      %key_base, %num_threads, {ilp}, %key_base;
+    bra             LOOP;
+
+END:
+    ret;
+}}
+"""
+    return code
+
+def generate_full_kernel(output_layout="bytes", input_mode="keys33", counter_positions=(31, 32),
+                         ilp=1, grid_stride=False):
+    """Generate the complete SHA256 PTX kernel
+    
+    input_mode keys33 reads one 33-byte key per thread from param_input.
+    input_mode counter builds each key on the device: the base record with
+    (param_start + key index) written little-endian into the input bytes
+    listed in counter_positions (byte 0 of the counter first).
+    input_mode node64 reads 64 bytes per key: two child digests as 16
+    native-endian words (a Merkle internal node); the padding block that
+    follows is compiled in.
+    input_mode prefix enumerates the same keys but starts from a host-side
+    descriptor (param_prefix): the state after the rounds whose message words
+    hold no counter byte, and the fixed part of every later schedule word.
+    input_mode arena hashes messages of any length: param_entries holds one
+    SHA256ArenaEntry per thread (see include/sha256_arena.h) locating its
+    message in param_input, and each thread pads and loops over its blocks.
+    
+    With ilp > 1 (which implies grid_stride) each thread hashes ilp keys per
+    loop iteration with their rounds interleaved; see generate_strided_body.
+    """
+    
+    if ilp > 1:
+        grid_stride = True
+    
+    header = f"""// SHA256 PTX Kernel - Auto-generated with all 64 rounds
+// Generated by generate_sha256_ptx.py (input mode: {input_mode}, output layout: {output_layout}, ilp: {ilp}{", grid-stride" if grid_stride else ""})
+
+.version 8.7
+.target sm_120
+.address_size 64
+
+// Kernel shape: input mode, output mode, hashes per thread iteration, grid-stride loop
+.visible .const .align 4 .b32 sha256_kernel_info[4] = {{{INPUT_MODES[input_mode]}, {OUTPUT_MODES[output_layout]}, {ilp}, {int(grid_stride)}}};
+"""
+    if input_mode in ENUMERATED_INPUTS:
+        layout = [len(counter_positions)] + list(counter_positions)
+        layout += [0] * (1 + COUNTER_MAX_BYTES - len(layout))
+        header += f"""
+// Counter layout: number of counter bytes, then the input byte receiving each
+.visible .const .align 4 .b32 sha256_counter_layout[{1 + COUNTER_MAX_BYTES}] = {{{", ".join(str(v) for v in layout)}}};
+"""
+    k_rows = ",\n".join("    " + ", ".join(f"0x{k:08x}" for k in SHA256_K[i:i + 4])
+                         for i in range(0, 64, 4))
+    header += f"""
+// SHA256 K constants
+.const .align 4 .b32 K[64] = {{
+{k_rows}
+}};
+"""
+    if grid_stride:
+        return header + generate_strided_body(input_mode, output_layout, counter_positions, ilp)
+    
+    header += generate_entry(input_mode, output_layout)
+    
+    if input_mode == "arena":
+        return header + generate_arena_blocks() + generate_output_store(output_layout) + """
+END:
+    ret;
+}
+"""
+    
+    load_input = generate_input_load(input_mode, counter_positions)
+    
+    # All 64 rounds; match mode tests the filter after round 60 and only
+    # candidates run the last three
+    if output_layout == "match":
+        rounds = (generate_rounds(input_mode, counter_positions, 0, 61) + generate_early_reject(guard=None, chained=input_mode == "node64") +
+                  """    @!%p1 bra       END;
+""" + generate_rounds(input_mode, counter_positions, 61, 64))
+    else:
+        rounds = generate_rounds(input_mode, counter_positions)
     
     # Final addition and output
     footer = """
@@ -281,18 +1080,8 @@ def generate_full_kernel():
     add.u32         %h6, %h6, %g;
     add.u32         %h7, %h7, %h;
     
-    // Store output as big-endian bytes
-"""
-    for i in range(8):
-        offset = i * 4
-        footer += f"""    shr.u32         %r40, %h{i}, 24;
-    st.global.u8    [%output_ptr+{offset}], %r40;
-    shr.u32         %r41, %h{i}, 16;
-    st.global.u8    [%output_ptr+{offset+1}], %r41;
-    shr.u32         %r42, %h{i}, 8;
-    st.global.u8    [%output_ptr+{offset+2}], %r42;
-    st.global.u8    [%output_ptr+{offset+3}], %h{i};
 """
+    footer += generate_output_store(output_layout)
     
     footer += """
 END:
@@ -302,13 +1091,60 @@ END:
     
     return header + load_input + rounds + footer
 
+def parse_counter_positions(text):
+    """Parse and validate a comma-separated list of counter byte positions"""
+    positions = [int(p) for p in text.split(",")]
+    if not 1 <= len(positions) <= COUNTER_MAX_BYTES:
+        raise argparse.ArgumentTypeError(f"1 to {COUNTER_MAX_BYTES} counter bytes")
+    if len(set(positions)) != len(positions) or not all(0 <= p < 33 for p in positions):
+        raise argparse.ArgumentTypeError("positions must be distinct input bytes 0..32")
+    return positions
+
+def default_output_path(input_mode, output_layout, ilp=1, grid_stride=False):
+    """Default PTX file name for a kernel variant"""
+    parts = []
+    if input_mode != "keys33":
+        parts.append(input_mode)
+    if output_layout != "bytes":
+        parts.append(output_layout)
+    if ilp > 1:
+        parts.append(f"ilp{ilp}")
+    elif grid_stride:
+        parts.append("stride")
+    if not parts:
+        return "ptx/sha256_kernel_full.ptx"
+    return f"ptx/sha256_kernel_{'_'.join(parts)}.ptx"
+
 if __name__ == "__main__":
-    kernel_code = generate_full_kernel()
+    parser = argparse.ArgumentParser(description="Generate the SHA256 PTX kernel")
+    parser.add_argument("--input-mode", choices=sorted(INPUT_MODES), default="keys33",
+                        help="keys33: read keys from memory; counter: build them on the device; "
+                             "prefix: counter with the fixed leading rounds precomputed on the host; "
+                             "node64: two child digests per key as native words; "
+                             "arena: variable-length messages from a packed arena")
+    parser.add_argument("--counter-positions", type=parse_counter_positions, default=[31, 32],
+                        help="input bytes receiving counter bytes 0, 1, ... (default: 31,32)")
+    parser.add_argument("--output-layout", choices=sorted(OUTPUT_MODES), default="bytes",
+                        help="digest layout written by the kernel (default: bytes)")
+    parser.add_argument("--ilp", type=int, choices=[1, 2, 4], default=1,
+                        help="independent hashes interleaved per thread (2 and 4 imply --grid-stride)")
+    parser.add_argument("--grid-stride", action="store_true",
+                        help="loop over the batch so a fixed number of resident threads covers any size")
+    parser.add_argument("-o", "--output", help="output PTX path")
+    args = parser.parse_args()
+    if args.input_mode == "arena" and (args.output_layout in HIT_LIST_LAYOUTS or args.ilp > 1 or args.grid_stride):
+        parser.error("--input-mode arena supports the bytes and words layouts, one message per thread")
+    
+    grid_stride = args.grid_stride or args.ilp > 1
+    kernel_code = generate_full_kernel(args.output_layout, args.input_mode, args.counter_positions,
+                                       args.ilp, grid_stride)
+    output_path = args.output or default_output_path(args.input_mode, args.output_layout,
+                                                      args.ilp, grid_stride)
     
-    with open("ptx/sha256_kernel_full.ptx", "w") as f:
+    with open(output_path, "w") as f:
         f.write(kernel_code)
     
-    print("✓ Generated ptx/sha256_kernel_full.ptx")
+    print(f"✓ Generated {output_path}")
     print(f"  Total lines: {len(kernel_code.splitlines())}")
     print("  All 64 rounds included")
     print("  Ready to compile and test!")
@@ -0,0 +1,89 @@
+/*
+ * Hash160 = RIPEMD160(SHA256(x)) for HASH256_PTX
+ */
+
+#include "hash160.h"
+#include "sha256.h"
+#include "sha256_lanes.h"
+#include "sha256_ops.h"
+#include "ripemd160.h"
+
+static_assert(SHA256_LANES == RIPEMD160_LANES, "fused Hash160 needs matching lane counts");
+
+static inline void WriteLE32(uint8_t* p, uint32_t x) {
+    p[0] = (uint8_t)x;
+    p[1] = (uint8_t)(x >> 8);
+    p[2] = (uint8_t)(x >> 16);
+    p[3] = (uint8_t)(x >> 24);
+}
+
+// RIPEMD-160 block for a 32-byte message whose bytes are the big-endian
+// SHA256 state words: RIPEMD reads little-endian words, so each state word
+// is byte-swapped; the rest is constant padding for a 256-bit message.
+static inline void SetPaddedSHA256Block(uint32_t x[16], const uint32_t sha_state[8]) {
+    for (int i = 0; i < 8; ++i) {
+        x[i] = Bswap32(sha_state[i]);
+    }
+    x[8] = 0x80;
+    for (int i = 9; i < 16; ++i) {
+        x[i] = 0;
+    }
+    x[14] = 256;
+}
+
+void Hash160(const uint8_t* data, size_t len, uint8_t hash[20]) {
+    uint32_t sha_state[8], x[16], state[5];
+
+    SHA256 sha;
+    sha.Update(data, len);
+    sha.FinalWords(sha_state);
+
+    SetPaddedSHA256Block(x, sha_state);
+    memcpy(state, RIPEMD160_IV, sizeof(state));
+    RIPEMD160TransformWords(state, x);
+
+    for (int i = 0; i < 5; ++i) {
+        WriteLE32(hash + i * 4, state[i]);
+    }
+}
+
+void Hash160Batch(const uint8_t* data, size_t len, uint8_t* hashes, size_t count) {
+    const uint8_t* lane_data[SHA256_LANES];
+    uint32_t sha_state[8][SHA256_LANES];
+    uint32_t x[16][RIPEMD160_LANES];
+    uint32_t state[5][RIPEMD160_LANES];
+
+    for (size_t base = 0; base < count; base += SHA256_LANES) {
+        // A short final group repeats its last message in the spare lanes
+        size_t active = count - base < SHA256_LANES ? count - base : SHA256_LANES;
+        for (size_t l = 0; l < SHA256_LANES; ++l) {
+            size_t n = l < active ? l : active - 1;
+            lane_data[l] = data + (base + n) * len;
+        }
+
+        SHA256HashLanes(SHA256_IV, 0, lane_data, len, sha_state);
+
+        for (int l = 0; l < RIPEMD160_LANES; ++l) {
+            for (int i = 0; i < 8; ++i) {
+                x[i][l] = Bswap32(sha_state[i][l]);
+            }
+            x[8][l] = 0x80;
+            for (int i = 9; i < 16; ++i) {
+                x[i][l] = 0;
+            }
+            x[14][l] = 256;
+        }
+        for (int i = 0; i < 5; ++i) {
+            for (int l = 0; l < RIPEMD160_LANES; ++l) {
+                state[i][l] = RIPEMD160_IV[i];
+            }
+        }
+        RIPEMD160TransformLanes(state, x);
+
+        for (size_t l = 0; l < active; ++l) {
+            for (int i = 0; i < 5; ++i) {
+                WriteLE32(hashes + (base + l) * 20 + i * 4, state[i][l]);
+            }
+        }
+    }
+}
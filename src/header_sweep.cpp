@@ -0,0 +1,157 @@
+/*
+ * Bitcoin block-header nonce sweep for HASH256_PTX
+ */
+
+#include "header_sweep.h"
+#include "sha256.h"
+#include "sha256_lanes.h"
+#include "sha256_ops.h"
+#include "sha256_shapes.h"
+#include <thread>
+#include <vector>
+
+// Everything a worker needs, fixed for the whole sweep
+struct SweepContext {
+    SHA256Prefix first;      // second header block from the midstate, nonce word varying
+    SHA256Prefix second;     // 32-byte second hash, all eight data words varying
+    uint8_t target[32];
+    uint32_t target_top;     // target bytes 31..28 as a number, for the quick reject
+};
+
+void HeaderHash(const uint8_t header[80], uint8_t hash[32]) {
+    uint32_t data[SHA256_SHAPE_HEADER80_DATA_WORDS], first[8], second[8];
+    for (int i = 0; i < SHA256_SHAPE_HEADER80_DATA_WORDS; ++i) {
+        data[i] = ReadBE32(header + i * 4);
+    }
+    memcpy(first, SHA256_IV, sizeof(first));
+    SHA256ShapeHeader80(first, data);
+    memcpy(second, SHA256_IV, sizeof(second));
+    SHA256ShapeDigest32(second, first);
+    for (int i = 0; i < 8; ++i) {
+        WriteBE32(hash + i * 4, second[i]);
+    }
+}
+
+void HeaderTargetFromBits(uint32_t bits, uint8_t target[32]) {
+    memset(target, 0, 32);
+    if (bits & 0x00800000) {
+        return;
+    }
+    int exponent = (int)(bits >> 24);
+    uint32_t mantissa = bits & 0x007fffff;
+    // target = mantissa * 256^(exponent - 3); bytes below position 0 drop out
+    for (int i = 0; i < 3; ++i) {
+        int pos = exponent - 3 + i;
+        uint8_t byte = (uint8_t)(mantissa >> (8 * i));
+        if (pos < 0 || !byte) {
+            continue;
+        }
+        if (pos >= 32) {
+            memset(target, 0, 32);
+            return;
+        }
+        target[pos] = byte;
+    }
+}
+
+bool HeaderHashMeetsTarget(const uint8_t hash[32], const uint8_t target[32]) {
+    for (int i = 31; i >= 0; --i) {
+        if (hash[i] != target[i]) {
+            return hash[i] < target[i];
+        }
+    }
+    return true;
+}
+
+static void InitSweep(SweepContext& ctx, const uint8_t header[80], const uint8_t target[32]) {
+    uint32_t midstate[8], block[16];
+
+    SHA256 sha;
+    sha.Update(header, 64);
+    sha.Midstate(midstate);
+
+    // Header bytes 64..79 in the padded second block of an 80-byte message;
+    // of its data words only the nonce (word 3) varies
+    memcpy(block, SHA256_SHAPE_HEADER80_BLOCK1, sizeof(block));
+    for (int i = 0; i < 3; ++i) {
+        block[i] = ReadBE32(header + 64 + i * 4);
+    }
+    SHA256PrefixInit(ctx.first, midstate, block, 1u << 3);
+
+    // Second hash: the first digest's words, all varying
+    SHA256PrefixInit(ctx.second, SHA256_IV, SHA256_SHAPE_DIGEST32_BLOCK0, SHA256_SHAPE_DIGEST32_VARYING0);
+
+    memcpy(ctx.target, target, 32);
+    ctx.target_top = ((uint32_t)target[31] << 24) | ((uint32_t)target[30] << 16) |
+                     ((uint32_t)target[29] << 8) | (uint32_t)target[28];
+}
+
+static void SweepRange(const SweepContext& ctx, uint32_t nonce_start, uint64_t count,
+                       std::vector<uint32_t>* found) {
+    uint32_t block[16][SHA256_LANES];
+    uint32_t digest_block[16][SHA256_LANES];
+    uint32_t out[8][SHA256_LANES];
+    uint8_t hash[32];
+
+    for (uint64_t base = 0; base < count; base += SHA256_LANES) {
+        uint64_t active = count - base < SHA256_LANES ? count - base : SHA256_LANES;
+        for (int l = 0; l < SHA256_LANES; ++l) {
+            block[3][l] = Bswap32(nonce_start + (uint32_t)(base + l));
+        }
+
+        // The first digest lands directly in the second block's data words
+        SHA256TransformLanesPrefix(ctx.first, block, digest_block);
+        SHA256TransformLanesPrefix(ctx.second, digest_block, out);
+
+        for (uint64_t l = 0; l < active; ++l) {
+            // Hash bytes 31..28 are H7 byte-swapped; almost every nonce fails here
+            if (Bswap32(out[7][l]) > ctx.target_top) {
+                continue;
+            }
+            for (int i = 0; i < 8; ++i) {
+                WriteBE32(hash + i * 4, out[i][l]);
+            }
+            if (HeaderHashMeetsTarget(hash, ctx.target)) {
+                found->push_back(nonce_start + (uint32_t)(base + l));
+            }
+        }
+    }
+}
+
+size_t HeaderSweep(const uint8_t header[80], const uint8_t target[32], uint32_t nonce_start, uint64_t count,
+                   uint32_t* nonces, size_t max_nonces, unsigned num_threads) {
+    SweepContext ctx;
+    InitSweep(ctx, header, target);
+
+    if (num_threads == 0) {
+        num_threads = std::thread::hardware_concurrency();
+        if (num_threads == 0) {
+            num_threads = 1;
+        }
+    }
+
+    // Contiguous shares of whole lane groups, one per thread
+    uint64_t share = (count + num_threads - 1) / num_threads;
+    share = (share + SHA256_LANES - 1) / SHA256_LANES * SHA256_LANES;
+    std::vector<std::vector<uint32_t> > found(num_threads);
+    std::vector<std::thread> workers;
+    for (unsigned t = 1; t < num_threads && t * share < count; ++t) {
+        uint64_t begin = t * share;
+        uint64_t n = count - begin < share ? count - begin : share;
+        workers.push_back(std::thread(SweepRange, std::cref(ctx), nonce_start + (uint32_t)begin, n, &found[t]));
+    }
+    SweepRange(ctx, nonce_start, count < share ? count : share, &found[0]);
+    for (size_t t = 0; t < workers.size(); ++t) {
+        workers[t].join();
+    }
+
+    size_t total = 0;
+    for (unsigned t = 0; t < num_threads; ++t) {
+        for (size_t i = 0; i < found[t].size(); ++i, ++total) {
+            if (total < max_nonces) {
+                nonces[total] = found[t][i];
+            }
+        }
+    }
+    return total;
+}
@@ -0,0 +1,80 @@
+/*
+ * HKDF-SHA256 (RFC 5869) for HASH256_PTX
+ */
+
+#include "hkdf.h"
+#include "sha256.h"
+#include "sha256_ops.h"
+
+void HKDFExtract(const uint8_t* salt, size_t salt_len, const uint8_t* ikm, size_t ikm_len, uint8_t prk[32]) {
+    static const uint8_t zero_salt[32] = {0};
+    if (salt_len == 0) {
+        salt = zero_salt;
+        salt_len = sizeof(zero_salt);
+    }
+    HMACSHA256(salt, salt_len, ikm, ikm_len, prk);
+}
+
+void HKDFExpandInit(HKDFExpander& ctx, const uint8_t* prk, size_t prk_len, const uint8_t* info, size_t info_len) {
+    HMACSHA256KeyInit(ctx.prk, prk, prk_len);
+    ctx.info = info;
+    ctx.info_len = info_len;
+    ctx.counter = 0;
+    ctx.used = sizeof(ctx.block);
+}
+
+// T(counter + 1) from T(counter), in place
+static void NextBlock(HKDFExpander& ctx) {
+    uint32_t words[16], out[8];
+    uint8_t index = (uint8_t)(ctx.counter + 1);
+
+    SHA256 sha;
+    sha.SetMidstate(ctx.prk.inner, 64);
+    if (ctx.counter > 0) {
+        sha.Update(ctx.block, sizeof(ctx.block));
+    }
+    if (ctx.info_len > 0) {
+        sha.Update(ctx.info, ctx.info_len);
+    }
+    sha.Update(&index, 1);
+    sha.FinalWords(words);
+    SHA256PrefixTransform(ctx.prk.outer, words, out);
+
+    for (int i = 0; i < 8; ++i) {
+        WriteBE32(ctx.block + i * 4, out[i]);
+    }
+    ++ctx.counter;
+    ctx.used = 0;
+}
+
+bool HKDFExpandRead(HKDFExpander& ctx, uint8_t* out, size_t len) {
+    size_t produced = ctx.counter * sizeof(ctx.block) - (sizeof(ctx.block) - ctx.used);
+    if (len > HKDF_MAX_OUTPUT - produced) {
+        return false;
+    }
+    while (len > 0) {
+        if (ctx.used == sizeof(ctx.block)) {
+            NextBlock(ctx);
+        }
+        size_t n = sizeof(ctx.block) - ctx.used < len ? sizeof(ctx.block) - ctx.used : len;
+        memcpy(out, ctx.block + ctx.used, n);
+        ctx.used += n;
+        out += n;
+        len -= n;
+    }
+    return true;
+}
+
+bool HKDFExpand(const uint8_t* prk, size_t prk_len, const uint8_t* info, size_t info_len,
+                uint8_t* okm, size_t okm_len) {
+    HKDFExpander ctx;
+    HKDFExpandInit(ctx, prk, prk_len, info, info_len);
+    return HKDFExpandRead(ctx, okm, okm_len);
+}
+
+bool HKDF(const uint8_t* salt, size_t salt_len, const uint8_t* ikm, size_t ikm_len,
+          const uint8_t* info, size_t info_len, uint8_t* okm, size_t okm_len) {
+    uint8_t prk[32];
+    HKDFExtract(salt, salt_len, ikm, ikm_len, prk);
+    return HKDFExpand(prk, sizeof(prk), info, info_len, okm, okm_len);
+}
@@ -0,0 +1,85 @@
+/*
+ * HMAC-SHA256 for HASH256_PTX
+ */
+
+#include "hmac_sha256.h"
+#include "sha256.h"
+#include "sha256_lanes.h"
+#include "sha256_ops.h"
+
+void HMACSHA256KeyInit(HMACSHA256Key& key, const uint8_t* data, size_t len) {
+    uint8_t pad[64];
+    memset(pad, 0, sizeof(pad));
+    if (len > 64) {
+        SHA256::Hash(data, len, pad);
+    } else if (len > 0) {
+        memcpy(pad, data, len);
+    }
+
+    SHA256 sha;
+    for (int i = 0; i < 64; ++i) {
+        pad[i] ^= 0x36;
+    }
+    sha.Update(pad, 64);
+    sha.Midstate(key.inner);
+
+    uint32_t outer[8];
+    for (int i = 0; i < 64; ++i) {
+        pad[i] ^= 0x36 ^ 0x5c;
+    }
+    sha.Init();
+    sha.Update(pad, 64);
+    sha.Midstate(outer);
+
+    // Outer block: inner digest words 0..7, then padding for 64 + 32 bytes
+    uint32_t block[16] = {0};
+    block[8] = 0x80000000;
+    block[15] = (64 + 32) * 8;
+    SHA256PrefixInit(key.outer, outer, block, 0xff);
+}
+
+void HMACSHA256(const HMACSHA256Key& key, const uint8_t* msg, size_t len, uint8_t mac[32]) {
+    uint32_t block[16], out[8];
+
+    SHA256 sha;
+    sha.SetMidstate(key.inner, 64);
+    sha.Update(msg, len);
+    sha.FinalWords(block);
+
+    SHA256PrefixTransform(key.outer, block, out);
+    for (int i = 0; i < 8; ++i) {
+        WriteBE32(mac + i * 4, out[i]);
+    }
+}
+
+void HMACSHA256(const uint8_t* key, size_t key_len, const uint8_t* msg, size_t len, uint8_t mac[32]) {
+    HMACSHA256Key k;
+    HMACSHA256KeyInit(k, key, key_len);
+    HMACSHA256(k, msg, len, mac);
+}
+
+void HMACSHA256Batch(const HMACSHA256Key& key, const uint8_t* msgs, size_t len, uint8_t* macs, size_t count) {
+    const uint8_t* lane_data[SHA256_LANES];
+    uint32_t inner[16][SHA256_LANES];
+    uint32_t out[8][SHA256_LANES];
+
+    for (size_t base = 0; base < count; base += SHA256_LANES) {
+        // A short final group repeats its last message in the spare lanes
+        size_t active = count - base < SHA256_LANES ? count - base : SHA256_LANES;
+        for (size_t l = 0; l < SHA256_LANES; ++l) {
+            size_t n = l < active ? l : active - 1;
+            lane_data[l] = msgs + (base + n) * len;
+        }
+
+        // The inner digests land directly in the outer block's data words;
+        // the prefix descriptor never reads words 8..15
+        SHA256HashLanes(key.inner, 64, lane_data, len, inner);
+        SHA256TransformLanesPrefix(key.outer, inner, out);
+
+        for (size_t l = 0; l < active; ++l) {
+            for (int i = 0; i < 8; ++i) {
+                WriteBE32(macs + (base + l) * 32 + i * 4, out[i][l]);
+            }
+        }
+    }
+}
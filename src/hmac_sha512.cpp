@@ -0,0 +1,99 @@
+/*
+ * HMAC-SHA512 for HASH256_PTX
+ */
+
+#include "hmac_sha512.h"
+#include "sha512.h"
+#include "sha512_lanes.h"
+#include "sha512_ops.h"
+
+// Outer block: the inner digest, then padding for 128 + 64 bytes
+static void SetOuterBlock(uint64_t block[16], const uint64_t digest[8]) {
+    memcpy(block, digest, 8 * sizeof(uint64_t));
+    block[8] = 0x8000000000000000ULL;
+    for (int i = 9; i < 15; ++i) {
+        block[i] = 0;
+    }
+    block[15] = (128 + 64) * 8;
+}
+
+void HMACSHA512KeyInit(HMACSHA512Key& key, const uint8_t* data, size_t len) {
+    uint8_t pad[128];
+    memset(pad, 0, sizeof(pad));
+    if (len > 128) {
+        SHA512::Hash(data, len, pad);
+    } else if (len > 0) {
+        memcpy(pad, data, len);
+    }
+
+    SHA512 sha;
+    for (int i = 0; i < 128; ++i) {
+        pad[i] ^= 0x36;
+    }
+    sha.Update(pad, 128);
+    sha.Midstate(key.inner);
+
+    for (int i = 0; i < 128; ++i) {
+        pad[i] ^= 0x36 ^ 0x5c;
+    }
+    sha.Init();
+    sha.Update(pad, 128);
+    sha.Midstate(key.outer);
+}
+
+void HMACSHA512(const HMACSHA512Key& key, const uint8_t* msg, size_t len, uint8_t mac[64]) {
+    uint8_t digest[64];
+
+    SHA512 sha;
+    sha.SetMidstate(key.inner, 128);
+    sha.Update(msg, len);
+    sha.Final(digest);
+
+    // 64 digest bytes after the 128-byte pad: padding fits, one compression
+    sha.SetMidstate(key.outer, 128);
+    sha.Update(digest, 64);
+    sha.Final(mac);
+}
+
+void HMACSHA512(const uint8_t* key, size_t key_len, const uint8_t* msg, size_t len, uint8_t mac[64]) {
+    HMACSHA512Key k;
+    HMACSHA512KeyInit(k, key, key_len);
+    HMACSHA512(k, msg, len, mac);
+}
+
+void HMACSHA512Batch(const HMACSHA512Key& key, const uint8_t* msgs, size_t len, uint8_t* macs, size_t count) {
+    const uint8_t* lane_data[SHA512_LANES];
+    uint64_t inner[8][SHA512_LANES];
+    uint64_t block[16][SHA512_LANES];
+    uint64_t state[8][SHA512_LANES];
+
+    for (size_t base = 0; base < count; base += SHA512_LANES) {
+        // A short final group repeats its last message in the spare lanes
+        size_t active = count - base < SHA512_LANES ? count - base : SHA512_LANES;
+        for (size_t l = 0; l < SHA512_LANES; ++l) {
+            size_t n = l < active ? l : active - 1;
+            lane_data[l] = msgs + (base + n) * len;
+        }
+
+        SHA512HashLanes(key.inner, 128, lane_data, len, inner);
+
+        for (int l = 0; l < SHA512_LANES; ++l) {
+            uint64_t digest[8], words[16];
+            for (int i = 0; i < 8; ++i) {
+                digest[i] = inner[i][l];
+                state[i][l] = key.outer[i];
+            }
+            SetOuterBlock(words, digest);
+            for (int i = 0; i < 16; ++i) {
+                block[i][l] = words[i];
+            }
+        }
+        SHA512TransformLanes(state, block);
+
+        for (size_t l = 0; l < active; ++l) {
+            for (int i = 0; i < 8; ++i) {
+                WriteBE64(macs + (base + l) * 64 + i * 8, state[i][l]);
+            }
+        }
+    }
+}
@@ -0,0 +1,128 @@
+/*
+ * On-device key enumeration layout for HASH256_PTX
+ */
+
+#include "key_counter.h"
+#include "sha256.h"
+#include "sha256_lanes.h"
+#include "sha256_ops.h"
+
+const KeyCounterLayout KEY_COUNTER_DEFAULT_LAYOUT = {2, {31, 32}};
+
+bool KeyCounterLayoutValid(const KeyCounterLayout& layout) {
+    if (layout.num_bytes < 1 || layout.num_bytes > KEY_COUNTER_MAX_BYTES) {
+        return false;
+    }
+    for (uint32_t i = 0; i < layout.num_bytes; ++i) {
+        if (layout.positions[i] >= KEY_COUNTER_KEY_SIZE) {
+            return false;
+        }
+        for (uint32_t j = 0; j < i; ++j) {
+            if (layout.positions[i] == layout.positions[j]) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+bool KeyCounterLayoutEqual(const KeyCounterLayout& a, const KeyCounterLayout& b) {
+    if (a.num_bytes != b.num_bytes) {
+        return false;
+    }
+    for (uint32_t i = 0; i < a.num_bytes && i < KEY_COUNTER_MAX_BYTES; ++i) {
+        if (a.positions[i] != b.positions[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void KeyCounterApply(uint8_t* key, const KeyCounterLayout& layout, uint64_t value) {
+    for (uint32_t i = 0; i < layout.num_bytes; ++i) {
+        key[layout.positions[i]] = (uint8_t)(value >> (8 * i));
+    }
+}
+
+void KeyCounterEnumerate(const uint8_t base[33], const KeyCounterLayout& layout,
+                         uint64_t start, uint8_t* keys, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        uint8_t* key = keys + i * KEY_COUNTER_KEY_SIZE;
+        memcpy(key, base, KEY_COUNTER_KEY_SIZE);
+        KeyCounterApply(key, layout, start + i);
+    }
+}
+
+void KeyCounterHashBatch(const uint8_t base[33], const KeyCounterLayout& layout,
+                         uint64_t start, uint8_t* hashes, size_t count) {
+    uint8_t key[KEY_COUNTER_KEY_SIZE];
+    memcpy(key, base, KEY_COUNTER_KEY_SIZE);
+    for (size_t i = 0; i < count; ++i) {
+        KeyCounterApply(key, layout, start + i);
+        SHA256::Hash(key, KEY_COUNTER_KEY_SIZE, hashes + i * 32);
+    }
+}
+
+void KeyCounterBaseWords(const uint8_t base[33], const KeyCounterLayout& layout, uint32_t words[9]) {
+    uint8_t padded[36];
+    memcpy(padded, base, KEY_COUNTER_KEY_SIZE);
+    KeyCounterApply(padded, layout, 0);
+    padded[33] = 0x80;
+    padded[34] = 0;
+    padded[35] = 0;
+    for (int i = 0; i < 9; ++i) {
+        words[i] = ReadBE32(padded + i * 4);
+    }
+}
+
+uint32_t KeyCounterVaryingWords(const KeyCounterLayout& layout) {
+    uint32_t words = 0;
+    for (uint32_t i = 0; i < layout.num_bytes; ++i) {
+        words |= 1u << (layout.positions[i] / 4);
+    }
+    return words;
+}
+
+void KeyCounterPrefixInit(const uint8_t base[33], const KeyCounterLayout& layout, SHA256Prefix& prefix) {
+    uint32_t block[16];
+    KeyCounterBaseWords(base, layout, block);
+    for (int i = 9; i < 15; ++i) {
+        block[i] = 0;
+    }
+    block[15] = KEY_COUNTER_KEY_SIZE * 8;
+    SHA256PrefixInit(prefix, SHA256_IV, block, KeyCounterVaryingWords(layout));
+}
+
+void KeyCounterPrefixHashBatch(const SHA256Prefix& prefix, const KeyCounterLayout& layout,
+                               uint64_t start, uint8_t* hashes, size_t count) {
+    uint32_t block[16][SHA256_LANES];
+    uint32_t out[8][SHA256_LANES];
+
+    for (size_t base = 0; base < count; base += SHA256_LANES) {
+        size_t active = count - base < SHA256_LANES ? count - base : SHA256_LANES;
+
+        // Counter bytes are ORed into the base words, whose counter bytes are zero
+        for (uint32_t i = 0; i < 16; ++i) {
+            if ((prefix.varying_words >> i) & 1) {
+                for (int l = 0; l < SHA256_LANES; ++l) {
+                    block[i][l] = prefix.schedule[i];
+                }
+            }
+        }
+        for (int l = 0; l < SHA256_LANES; ++l) {
+            uint64_t value = start + base + l;
+            for (uint32_t j = 0; j < layout.num_bytes; ++j) {
+                uint32_t pos = layout.positions[j];
+                block[pos / 4][l] |= (uint32_t)(uint8_t)(value >> (8 * j)) << ((3 - pos % 4) * 8);
+            }
+        }
+
+        SHA256TransformLanesPrefix(prefix, block, out);
+
+        for (size_t l = 0; l < active; ++l) {
+            for (int i = 0; i < 8; ++i) {
+                WriteBE32(hashes + (base + l) * 32 + i * 4, out[i][l]);
+            }
+        }
+    }
+}
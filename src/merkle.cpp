@@ -0,0 +1,193 @@
+/*
+ * Bitcoin Merkle roots for HASH256_PTX
+ */
+
+#include "merkle.h"
+#include "sha256.h"
+#include "sha256_digest.h"
+#include "sha256_node.h"
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+// Below this many parents per thread a level is hashed on the calling thread
+static const size_t MERKLE_MIN_NODES_PER_THREAD = 1024;
+
+size_t MerkleDepth(size_t count) {
+    size_t depth = 0;
+    for (; count > 1; count = (count + 1) / 2) {
+        ++depth;
+    }
+    return depth;
+}
+
+// Hash the num_parents pairs of a level, sharing them out across threads
+static void HashLevel(const uint32_t* children, uint32_t* parents, size_t num_parents, unsigned num_threads) {
+    size_t max_threads = num_parents / MERKLE_MIN_NODES_PER_THREAD;
+    if (num_threads > max_threads) {
+        num_threads = max_threads ? (unsigned)max_threads : 1;
+    }
+    size_t share = (num_parents + num_threads - 1) / num_threads;
+    std::vector<std::thread> workers;
+    for (unsigned t = 1; t < num_threads; ++t) {
+        size_t begin = t * share;
+        if (begin >= num_parents) {
+            break;
+        }
+        size_t n = num_parents - begin < share ? num_parents - begin : share;
+        workers.push_back(std::thread(SHA256dNode64Batch, children + begin * 16, parents + begin * 8, n));
+    }
+    SHA256dNode64Batch(children, parents, num_parents < share ? num_parents : share);
+    for (size_t t = 0; t < workers.size(); ++t) {
+        workers[t].join();
+    }
+}
+
+void MerkleRoot(const uint8_t* txids, size_t count, uint8_t root[32],
+                size_t leaf, uint8_t* path, unsigned num_threads) {
+    if (count == 0) {
+        memset(root, 0, 32);
+        return;
+    }
+    if (num_threads == 0) {
+        num_threads = std::thread::hardware_concurrency();
+        if (num_threads == 0) {
+            num_threads = 1;
+        }
+    }
+
+    // Two level buffers in word layout, each with room for the duplicated
+    // odd node. Levels alternate between them so threads never read a pair
+    // another thread is overwriting.
+    std::vector<uint32_t> level((count + 1) * 8), next(((count + 1) / 2 + 1) * 8);
+    DigestBytesToWords(txids, &level[0], count);
+
+    for (size_t n = count; n > 1; n = (n + 1) / 2) {
+        if (n & 1) {
+            memcpy(&level[n * 8], &level[(n - 1) * 8], 32);
+        }
+        if (path) {
+            DigestWordsToBytes(&level[(leaf ^ 1) * 8], path, 1);
+            path += 32;
+            leaf >>= 1;
+        }
+        HashLevel(&level[0], &next[0], (n + 1) / 2, num_threads);
+        level.swap(next);
+    }
+    DigestWordsToBytes(&level[0], root, 1);
+}
+
+void MerkleRootFromPath(const uint8_t hash[32], size_t index, const uint8_t* path, size_t depth,
+                        uint8_t root[32]) {
+    uint8_t node[64], first[32];
+    memcpy(root, hash, 32);
+    for (size_t i = 0; i < depth; ++i, index >>= 1) {
+        if (index & 1) {
+            memcpy(node, path + i * 32, 32);
+            memcpy(node + 32, root, 32);
+        } else {
+            memcpy(node, root, 32);
+            memcpy(node + 32, path + i * 32, 32);
+        }
+        SHA256::Hash(node, 64, first);
+        SHA256::Hash(first, 32, root);
+    }
+}
+
+MerkleTree::MerkleTree() : levels(1) {
+}
+
+void MerkleTree::Clear() {
+    levels.assign(1, std::vector<uint32_t>());
+}
+
+void MerkleTree::Append(const uint8_t leaf[32]) {
+    AppendBatch(leaf, 1);
+}
+
+void MerkleTree::AppendBatch(const uint8_t* leaves, size_t count) {
+    if (count == 0) {
+        return;
+    }
+    size_t first = Size();
+    levels[0].resize((first + count) * 8);
+    DigestBytesToWords(leaves, &levels[0][first * 8], count);
+
+    std::vector<size_t> dirty(count);
+    for (size_t i = 0; i < count; ++i) {
+        dirty[i] = first + i;
+    }
+    Rehash(dirty);
+}
+
+void MerkleTree::Update(size_t index, const uint8_t leaf[32]) {
+    UpdateBatch(&index, leaf, 1);
+}
+
+void MerkleTree::UpdateBatch(const size_t* indices, const uint8_t* leaves, size_t count) {
+    if (count == 0) {
+        return;
+    }
+    std::vector<size_t> dirty(indices, indices + count);
+    for (size_t i = 0; i < count; ++i) {
+        DigestBytesToWords(leaves + i * 32, &levels[0][indices[i] * 8], 1);
+    }
+    std::sort(dirty.begin(), dirty.end());
+    dirty.erase(std::unique(dirty.begin(), dirty.end()), dirty.end());
+    Rehash(dirty);
+}
+
+void MerkleTree::Rehash(std::vector<size_t>& dirty) {
+    for (size_t k = 0; levels[k].size() > 8; ++k) {
+        size_t n = levels[k].size() / 8;
+        if (k + 1 == levels.size()) {
+            levels.push_back(std::vector<uint32_t>());
+        }
+        levels[k + 1].resize((n + 1) / 2 * 8);
+
+        // Parents of the dirty nodes, still sorted; siblings share one
+        size_t num_parents = 0;
+        for (size_t i = 0; i < dirty.size(); ++i) {
+            size_t parent = dirty[i] >> 1;
+            if (num_parents == 0 || dirty[num_parents - 1] != parent) {
+                dirty[num_parents++] = parent;
+            }
+        }
+        dirty.resize(num_parents);
+        if (num_parents == 0) {
+            return;
+        }
+
+        // Gather the child pairs (an odd last node pairs with itself), hash
+        // them as one batch in place and scatter the parents
+        const uint32_t* level = &levels[k][0];
+        scratch.resize(num_parents * 16);
+        for (size_t i = 0; i < num_parents; ++i) {
+            size_t left = dirty[i] * 2;
+            size_t right = left + 1 < n ? left + 1 : left;
+            memcpy(&scratch[i * 16], level + left * 8, 32);
+            memcpy(&scratch[i * 16 + 8], level + right * 8, 32);
+        }
+        SHA256dNode64Batch(&scratch[0], &scratch[0], num_parents);
+        for (size_t i = 0; i < num_parents; ++i) {
+            memcpy(&levels[k + 1][dirty[i] * 8], &scratch[i * 8], 32);
+        }
+    }
+}
+
+void MerkleTree::Root(uint8_t root[32]) const {
+    if (Size() == 0) {
+        memset(root, 0, 32);
+        return;
+    }
+    DigestWordsToBytes(&levels[MerkleDepth(Size())][0], root, 1);
+}
+
+void MerkleTree::Path(size_t index, uint8_t* path) const {
+    size_t depth = MerkleDepth(Size());
+    for (size_t k = 0; k < depth; ++k, index >>= 1, path += 32) {
+        size_t n = levels[k].size() / 8;
+        size_t sibling = (index ^ 1) < n ? index ^ 1 : index;
+        DigestWordsToBytes(&levels[k][sibling * 8], path, 1);
+    }
+}
@@ -0,0 +1,153 @@
+/*
+ * PBKDF2-HMAC-SHA256 for HASH256_PTX
+ */
+
+#include "pbkdf2.h"
+#include "hmac_sha256.h"
+#include "sha256.h"
+#include "sha256_lanes.h"
+#include "sha256_ops.h"
+#include <thread>
+#include <vector>
+
+// One output block of one job
+struct PBKDF2Task {
+    const PBKDF2Job* job;
+    const HMACSHA256Key* key;
+    uint32_t block;               // 1-based block index i
+};
+
+// Iteration blocks: digest words 0..7, then padding for 64 + 32 bytes
+static SHA256Prefix MakePad96Prefix(const uint32_t init[8]) {
+    uint32_t block[16] = {0};
+    block[8] = 0x80000000;
+    block[15] = (64 + 32) * 8;
+    SHA256Prefix prefix;
+    SHA256PrefixInit(prefix, init, block, 0xff);
+    return prefix;
+}
+
+// U_1 = HMAC(P, S || INT(i)) as digest words
+static void FirstU(const HMACSHA256Key& key, const uint8_t* salt, size_t salt_len, uint32_t block,
+                   uint32_t u[16]) {
+    uint8_t index[4];
+    WriteBE32(index, block);
+
+    SHA256 sha;
+    sha.SetMidstate(key.inner, 64);
+    sha.Update(salt, salt_len);
+    sha.Update(index, 4);
+    sha.FinalWords(u);
+    SHA256PrefixTransform(key.outer, u, u);
+}
+
+static void StoreBlock(const PBKDF2Job& job, uint32_t block, const uint32_t t[8]) {
+    uint8_t bytes[32];
+    for (int i = 0; i < 8; ++i) {
+        WriteBE32(bytes + i * 4, t[i]);
+    }
+    size_t offset = (size_t)(block - 1) * 32;
+    size_t n = job.key_len - offset < 32 ? job.key_len - offset : 32;
+    memcpy(job.key + offset, bytes, n);
+}
+
+void PBKDF2HMACSHA256(const uint8_t* password, size_t password_len, const uint8_t* salt, size_t salt_len,
+                      uint32_t iterations, uint8_t* key, size_t key_len) {
+    PBKDF2Job job = {password, password_len, salt, salt_len, key, key_len};
+    HMACSHA256Key k;
+    HMACSHA256KeyInit(k, password, password_len);
+    SHA256Prefix inner = MakePad96Prefix(k.inner);
+
+    uint32_t blocks = (uint32_t)((key_len + 31) / 32);
+    for (uint32_t b = 1; b <= blocks; ++b) {
+        uint32_t u[16], t[8];
+        FirstU(k, salt, salt_len, b, u);
+        memcpy(t, u, sizeof(t));
+        for (uint32_t j = 1; j < iterations; ++j) {
+            SHA256PrefixTransform(inner, u, u);
+            SHA256PrefixTransform(k.outer, u, u);
+            for (int i = 0; i < 8; ++i) {
+                t[i] ^= u[i];
+            }
+        }
+        StoreBlock(job, b, t);
+    }
+}
+
+static void RunTasks(const PBKDF2Task* tasks, size_t count, uint32_t iterations) {
+    // Only the schedule is used; each lane brings its own chaining values
+    static const SHA256Prefix pad96 = MakePad96Prefix(SHA256_IV);
+    uint32_t inner[8][SHA256_LANES], outer[8][SHA256_LANES];
+    uint32_t u[16][SHA256_LANES], t[8][SHA256_LANES];
+
+    for (size_t base = 0; base < count; base += SHA256_LANES) {
+        // A short final group repeats its last task in the spare lanes
+        size_t active = count - base < SHA256_LANES ? count - base : SHA256_LANES;
+        for (size_t l = 0; l < SHA256_LANES; ++l) {
+            const PBKDF2Task& task = tasks[base + (l < active ? l : active - 1)];
+            uint32_t first[16];
+            FirstU(*task.key, task.job->salt, task.job->salt_len, task.block, first);
+            for (int i = 0; i < 8; ++i) {
+                inner[i][l] = task.key->inner[i];
+                outer[i][l] = task.key->outer.init[i];
+                u[i][l] = first[i];
+                t[i][l] = first[i];
+            }
+        }
+
+        for (uint32_t j = 1; j < iterations; ++j) {
+            SHA256TransformLanesPrefixChained(pad96, inner, u, u);
+            SHA256TransformLanesPrefixChained(pad96, outer, u, u);
+            for (int i = 0; i < 8; ++i) {
+                for (int l = 0; l < SHA256_LANES; ++l) {
+                    t[i][l] ^= u[i][l];
+                }
+            }
+        }
+
+        for (size_t l = 0; l < active; ++l) {
+            uint32_t lane[8];
+            for (int i = 0; i < 8; ++i) {
+                lane[i] = t[i][l];
+            }
+            StoreBlock(*tasks[base + l].job, tasks[base + l].block, lane);
+        }
+    }
+}
+
+void PBKDF2HMACSHA256Batch(const PBKDF2Job* jobs, size_t count, uint32_t iterations, unsigned num_threads) {
+    std::vector<HMACSHA256Key> keys(count);
+    std::vector<PBKDF2Task> tasks;
+    for (size_t i = 0; i < count; ++i) {
+        HMACSHA256KeyInit(keys[i], jobs[i].password, jobs[i].password_len);
+        uint32_t blocks = (uint32_t)((jobs[i].key_len + 31) / 32);
+        for (uint32_t b = 1; b <= blocks; ++b) {
+            PBKDF2Task task = {&jobs[i], &keys[i], b};
+            tasks.push_back(task);
+        }
+    }
+    if (tasks.empty()) {
+        return;
+    }
+
+    if (num_threads == 0) {
+        num_threads = std::thread::hardware_concurrency();
+        if (num_threads == 0) {
+            num_threads = 1;
+        }
+    }
+
+    // Contiguous shares of whole lane groups, one per thread
+    size_t share = (tasks.size() + num_threads - 1) / num_threads;
+    share = (share + SHA256_LANES - 1) / SHA256_LANES * SHA256_LANES;
+    std::vector<std::thread> workers;
+    for (unsigned t = 1; t < num_threads && t * share < tasks.size(); ++t) {
+        size_t begin = t * share;
+        size_t n = tasks.size() - begin < share ? tasks.size() - begin : share;
+        workers.push_back(std::thread(RunTasks, &tasks[begin], n, iterations));
+    }
+    RunTasks(&tasks[0], tasks.size() < share ? tasks.size() : share, iterations);
+    for (size_t t = 0; t < workers.size(); ++t) {
+        workers[t].join();
+    }
+}
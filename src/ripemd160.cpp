@@ -0,0 +1,324 @@
+/*
+ * RIPEMD-160 implementation for HASH256_PTX
+ * Based on the RIPEMD-160 specification (Dobbertin, Bosselaers, Preneel)
+ */
+
+#include "ripemd160.h"
+
+#define ROL(x, n) (((x) << (n)) | ((x) >> (32 - (n))))
+#define F1(x, y, z) ((x) ^ (y) ^ (z))
+#define F2(x, y, z) (((x) & (y)) | (~(x) & (z)))
+#define F3(x, y, z) (((x) | ~(y)) ^ (z))
+#define F4(x, y, z) (((x) & (z)) | ((y) & ~(z)))
+#define F5(x, y, z) ((x) ^ ((y) | ~(z)))
+
+const uint32_t RIPEMD160_IV[5] = {
+    0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476, 0xc3d2e1f0
+};
+
+// The 80 steps of both lines, fully unrolled. Each entry is
+// STEP(f, a, b, c, d, e, message word, rotation, constant) and computes
+//   a = rol(a + f(b, c, d) + x[word] + constant, rotation) + e;  c = rol(c, 10)
+// The variable roles rotate from one step to the next instead of moving
+// values around; after 80 steps they are back in their original places.
+#define RIPEMD160_STEPS(STEP) \
+    STEP(F1, al, bl, cl, dl, el,  0, 11, 0x00000000) \
+    STEP(F5, ar, br, cr, dr, er,  5,  8, 0x50a28be6) \
+    STEP(F1, el, al, bl, cl, dl,  1, 14, 0x00000000) \
+    STEP(F5, er, ar, br, cr, dr, 14,  9, 0x50a28be6) \
+    STEP(F1, dl, el, al, bl, cl,  2, 15, 0x00000000) \
+    STEP(F5, dr, er, ar, br, cr,  7,  9, 0x50a28be6) \
+    STEP(F1, cl, dl, el, al, bl,  3, 12, 0x00000000) \
+    STEP(F5, cr, dr, er, ar, br,  0, 11, 0x50a28be6) \
+    STEP(F1, bl, cl, dl, el, al,  4,  5, 0x00000000) \
+    STEP(F5, br, cr, dr, er, ar,  9, 13, 0x50a28be6) \
+    STEP(F1, al, bl, cl, dl, el,  5,  8, 0x00000000) \
+    STEP(F5, ar, br, cr, dr, er,  2, 15, 0x50a28be6) \
+    STEP(F1, el, al, bl, cl, dl,  6,  7, 0x00000000) \
+    STEP(F5, er, ar, br, cr, dr, 11, 15, 0x50a28be6) \
+    STEP(F1, dl, el, al, bl, cl,  7,  9, 0x00000000) \
+    STEP(F5, dr, er, ar, br, cr,  4,  5, 0x50a28be6) \
+    STEP(F1, cl, dl, el, al, bl,  8, 11, 0x00000000) \
+    STEP(F5, cr, dr, er, ar, br, 13,  7, 0x50a28be6) \
+    STEP(F1, bl, cl, dl, el, al,  9, 13, 0x00000000) \
+    STEP(F5, br, cr, dr, er, ar,  6,  7, 0x50a28be6) \
+    STEP(F1, al, bl, cl, dl, el, 10, 14, 0x00000000) \
+    STEP(F5, ar, br, cr, dr, er, 15,  8, 0x50a28be6) \
+    STEP(F1, el, al, bl, cl, dl, 11, 15, 0x00000000) \
+    STEP(F5, er, ar, br, cr, dr,  8, 11, 0x50a28be6) \
+    STEP(F1, dl, el, al, bl, cl, 12,  6, 0x00000000) \
+    STEP(F5, dr, er, ar, br, cr,  1, 14, 0x50a28be6) \
+    STEP(F1, cl, dl, el, al, bl, 13,  7, 0x00000000) \
+    STEP(F5, cr, dr, er, ar, br, 10, 14, 0x50a28be6) \
+    STEP(F1, bl, cl, dl, el, al, 14,  9, 0x00000000) \
+    STEP(F5, br, cr, dr, er, ar,  3, 12, 0x50a28be6) \
+    STEP(F1, al, bl, cl, dl, el, 15,  8, 0x00000000) \
+    STEP(F5, ar, br, cr, dr, er, 12,  6, 0x50a28be6) \
+    STEP(F2, el, al, bl, cl, dl,  7,  7, 0x5a827999) \
+    STEP(F4, er, ar, br, cr, dr,  6,  9, 0x5c4dd124) \
+    STEP(F2, dl, el, al, bl, cl,  4,  6, 0x5a827999) \
+    STEP(F4, dr, er, ar, br, cr, 11, 13, 0x5c4dd124) \
+    STEP(F2, cl, dl, el, al, bl, 13,  8, 0x5a827999) \
+    STEP(F4, cr, dr, er, ar, br,  3, 15, 0x5c4dd124) \
+    STEP(F2, bl, cl, dl, el, al,  1, 13, 0x5a827999) \
+    STEP(F4, br, cr, dr, er, ar,  7,  7, 0x5c4dd124) \
+    STEP(F2, al, bl, cl, dl, el, 10, 11, 0x5a827999) \
+    STEP(F4, ar, br, cr, dr, er,  0, 12, 0x5c4dd124) \
+    STEP(F2, el, al, bl, cl, dl,  6,  9, 0x5a827999) \
+    STEP(F4, er, ar, br, cr, dr, 13,  8, 0x5c4dd124) \
+    STEP(F2, dl, el, al, bl, cl, 15,  7, 0x5a827999) \
+    STEP(F4, dr, er, ar, br, cr,  5,  9, 0x5c4dd124) \
+    STEP(F2, cl, dl, el, al, bl,  3, 15, 0x5a827999) \
+    STEP(F4, cr, dr, er, ar, br, 10, 11, 0x5c4dd124) \
+    STEP(F2, bl, cl, dl, el, al, 12,  7, 0x5a827999) \
+    STEP(F4, br, cr, dr, er, ar, 14,  7, 0x5c4dd124) \
+    STEP(F2, al, bl, cl, dl, el,  0, 12, 0x5a827999) \
+    STEP(F4, ar, br, cr, dr, er, 15,  7, 0x5c4dd124) \
+    STEP(F2, el, al, bl, cl, dl,  9, 15, 0x5a827999) \
+    STEP(F4, er, ar, br, cr, dr,  8, 12, 0x5c4dd124) \
+    STEP(F2, dl, el, al, bl, cl,  5,  9, 0x5a827999) \
+    STEP(F4, dr, er, ar, br, cr, 12,  7, 0x5c4dd124) \
+    STEP(F2, cl, dl, el, al, bl,  2, 11, 0x5a827999) \
+    STEP(F4, cr, dr, er, ar, br,  4,  6, 0x5c4dd124) \
+    STEP(F2, bl, cl, dl, el, al, 14,  7, 0x5a827999) \
+    STEP(F4, br, cr, dr, er, ar,  9, 15, 0x5c4dd124) \
+    STEP(F2, al, bl, cl, dl, el, 11, 13, 0x5a827999) \
+    STEP(F4, ar, br, cr, dr, er,  1, 13, 0x5c4dd124) \
+    STEP(F2, el, al, bl, cl, dl,  8, 12, 0x5a827999) \
+    STEP(F4, er, ar, br, cr, dr,  2, 11, 0x5c4dd124) \
+    STEP(F3, dl, el, al, bl, cl,  3, 11, 0x6ed9eba1) \
+    STEP(F3, dr, er, ar, br, cr, 15,  9, 0x6d703ef3) \
+    STEP(F3, cl, dl, el, al, bl, 10, 13, 0x6ed9eba1) \
+    STEP(F3, cr, dr, er, ar, br,  5,  7, 0x6d703ef3) \
+    STEP(F3, bl, cl, dl, el, al, 14,  6, 0x6ed9eba1) \
+    STEP(F3, br, cr, dr, er, ar,  1, 15, 0x6d703ef3) \
+    STEP(F3, al, bl, cl, dl, el,  4,  7, 0x6ed9eba1) \
+    STEP(F3, ar, br, cr, dr, er,  3, 11, 0x6d703ef3) \
+    STEP(F3, el, al, bl, cl, dl,  9, 14, 0x6ed9eba1) \
+    STEP(F3, er, ar, br, cr, dr,  7,  8, 0x6d703ef3) \
+    STEP(F3, dl, el, al, bl, cl, 15,  9, 0x6ed9eba1) \
+    STEP(F3, dr, er, ar, br, cr, 14,  6, 0x6d703ef3) \
+    STEP(F3, cl, dl, el, al, bl,  8, 13, 0x6ed9eba1) \
+    STEP(F3, cr, dr, er, ar, br,  6,  6, 0x6d703ef3) \
+    STEP(F3, bl, cl, dl, el, al,  1, 15, 0x6ed9eba1) \
+    STEP(F3, br, cr, dr, er, ar,  9, 14, 0x6d703ef3) \
+    STEP(F3, al, bl, cl, dl, el,  2, 14, 0x6ed9eba1) \
+    STEP(F3, ar, br, cr, dr, er, 11, 12, 0x6d703ef3) \
+    STEP(F3, el, al, bl, cl, dl,  7,  8, 0x6ed9eba1) \
+    STEP(F3, er, ar, br, cr, dr,  8, 13, 0x6d703ef3) \
+    STEP(F3, dl, el, al, bl, cl,  0, 13, 0x6ed9eba1) \
+    STEP(F3, dr, er, ar, br, cr, 12,  5, 0x6d703ef3) \
+    STEP(F3, cl, dl, el, al, bl,  6,  6, 0x6ed9eba1) \
+    STEP(F3, cr, dr, er, ar, br,  2, 14, 0x6d703ef3) \
+    STEP(F3, bl, cl, dl, el, al, 13,  5, 0x6ed9eba1) \
+    STEP(F3, br, cr, dr, er, ar, 10, 13, 0x6d703ef3) \
+    STEP(F3, al, bl, cl, dl, el, 11, 12, 0x6ed9eba1) \
+    STEP(F3, ar, br, cr, dr, er,  0, 13, 0x6d703ef3) \
+    STEP(F3, el, al, bl, cl, dl,  5,  7, 0x6ed9eba1) \
+    STEP(F3, er, ar, br, cr, dr,  4,  7, 0x6d703ef3) \
+    STEP(F3, dl, el, al, bl, cl, 12,  5, 0x6ed9eba1) \
+    STEP(F3, dr, er, ar, br, cr, 13,  5, 0x6d703ef3) \
+    STEP(F4, cl, dl, el, al, bl,  1, 11, 0x8f1bbcdc) \
+    STEP(F2, cr, dr, er, ar, br,  8, 15, 0x7a6d76e9) \
+    STEP(F4, bl, cl, dl, el, al,  9, 12, 0x8f1bbcdc) \
+    STEP(F2, br, cr, dr, er, ar,  6,  5, 0x7a6d76e9) \
+    STEP(F4, al, bl, cl, dl, el, 11, 14, 0x8f1bbcdc) \
+    STEP(F2, ar, br, cr, dr, er,  4,  8, 0x7a6d76e9) \
+    STEP(F4, el, al, bl, cl, dl, 10, 15, 0x8f1bbcdc) \
+    STEP(F2, er, ar, br, cr, dr,  1, 11, 0x7a6d76e9) \
+    STEP(F4, dl, el, al, bl, cl,  0, 14, 0x8f1bbcdc) \
+    STEP(F2, dr, er, ar, br, cr,  3, 14, 0x7a6d76e9) \
+    STEP(F4, cl, dl, el, al, bl,  8, 15, 0x8f1bbcdc) \
+    STEP(F2, cr, dr, er, ar, br, 11, 14, 0x7a6d76e9) \
+    STEP(F4, bl, cl, dl, el, al, 12,  9, 0x8f1bbcdc) \
+    STEP(F2, br, cr, dr, er, ar, 15,  6, 0x7a6d76e9) \
+    STEP(F4, al, bl, cl, dl, el,  4,  8, 0x8f1bbcdc) \
+    STEP(F2, ar, br, cr, dr, er,  0, 14, 0x7a6d76e9) \
+    STEP(F4, el, al, bl, cl, dl, 13,  9, 0x8f1bbcdc) \
+    STEP(F2, er, ar, br, cr, dr,  5,  6, 0x7a6d76e9) \
+    STEP(F4, dl, el, al, bl, cl,  3, 14, 0x8f1bbcdc) \
+    STEP(F2, dr, er, ar, br, cr, 12,  9, 0x7a6d76e9) \
+    STEP(F4, cl, dl, el, al, bl,  7,  5, 0x8f1bbcdc) \
+    STEP(F2, cr, dr, er, ar, br,  2, 12, 0x7a6d76e9) \
+    STEP(F4, bl, cl, dl, el, al, 15,  6, 0x8f1bbcdc) \
+    STEP(F2, br, cr, dr, er, ar, 13,  9, 0x7a6d76e9) \
+    STEP(F4, al, bl, cl, dl, el, 14,  8, 0x8f1bbcdc) \
+    STEP(F2, ar, br, cr, dr, er,  9, 12, 0x7a6d76e9) \
+    STEP(F4, el, al, bl, cl, dl,  5,  6, 0x8f1bbcdc) \
+    STEP(F2, er, ar, br, cr, dr,  7,  5, 0x7a6d76e9) \
+    STEP(F4, dl, el, al, bl, cl,  6,  5, 0x8f1bbcdc) \
+    STEP(F2, dr, er, ar, br, cr, 10, 15, 0x7a6d76e9) \
+    STEP(F4, cl, dl, el, al, bl,  2, 12, 0x8f1bbcdc) \
+    STEP(F2, cr, dr, er, ar, br, 14,  8, 0x7a6d76e9) \
+    STEP(F5, bl, cl, dl, el, al,  4,  9, 0xa953fd4e) \
+    STEP(F1, br, cr, dr, er, ar, 12,  8, 0x00000000) \
+    STEP(F5, al, bl, cl, dl, el,  0, 15, 0xa953fd4e) \
+    STEP(F1, ar, br, cr, dr, er, 15,  5, 0x00000000) \
+    STEP(F5, el, al, bl, cl, dl,  5,  5, 0xa953fd4e) \
+    STEP(F1, er, ar, br, cr, dr, 10, 12, 0x00000000) \
+    STEP(F5, dl, el, al, bl, cl,  9, 11, 0xa953fd4e) \
+    STEP(F1, dr, er, ar, br, cr,  4,  9, 0x00000000) \
+    STEP(F5, cl, dl, el, al, bl,  7,  6, 0xa953fd4e) \
+    STEP(F1, cr, dr, er, ar, br,  1, 12, 0x00000000) \
+    STEP(F5, bl, cl, dl, el, al, 12,  8, 0xa953fd4e) \
+    STEP(F1, br, cr, dr, er, ar,  5,  5, 0x00000000) \
+    STEP(F5, al, bl, cl, dl, el,  2, 13, 0xa953fd4e) \
+    STEP(F1, ar, br, cr, dr, er,  8, 14, 0x00000000) \
+    STEP(F5, el, al, bl, cl, dl, 10, 12, 0xa953fd4e) \
+    STEP(F1, er, ar, br, cr, dr,  7,  6, 0x00000000) \
+    STEP(F5, dl, el, al, bl, cl, 14,  5, 0xa953fd4e) \
+    STEP(F1, dr, er, ar, br, cr,  6,  8, 0x00000000) \
+    STEP(F5, cl, dl, el, al, bl,  1, 12, 0xa953fd4e) \
+    STEP(F1, cr, dr, er, ar, br,  2, 13, 0x00000000) \
+    STEP(F5, bl, cl, dl, el, al,  3, 13, 0xa953fd4e) \
+    STEP(F1, br, cr, dr, er, ar, 13,  6, 0x00000000) \
+    STEP(F5, al, bl, cl, dl, el,  8, 14, 0xa953fd4e) \
+    STEP(F1, ar, br, cr, dr, er, 14,  5, 0x00000000) \
+    STEP(F5, el, al, bl, cl, dl, 11, 11, 0xa953fd4e) \
+    STEP(F1, er, ar, br, cr, dr,  0, 15, 0x00000000) \
+    STEP(F5, dl, el, al, bl, cl,  6,  8, 0xa953fd4e) \
+    STEP(F1, dr, er, ar, br, cr,  3, 13, 0x00000000) \
+    STEP(F5, cl, dl, el, al, bl, 15,  5, 0xa953fd4e) \
+    STEP(F1, cr, dr, er, ar, br,  9, 11, 0x00000000) \
+    STEP(F5, bl, cl, dl, el, al, 13,  6, 0xa953fd4e) \
+    STEP(F1, br, cr, dr, er, ar, 11, 11, 0x00000000)
+
+void RIPEMD160TransformWords(uint32_t state[5], const uint32_t x[16]) {
+    uint32_t al = state[0], bl = state[1], cl = state[2], dl = state[3], el = state[4];
+    uint32_t ar = al, br = bl, cr = cl, dr = dl, er = el;
+
+#define STEP(F, a, b, c, d, e, r, s, k) \
+    a = ROL(a + F(b, c, d) + x[r] + k, s) + e; \
+    c = ROL(c, 10);
+
+    RIPEMD160_STEPS(STEP)
+#undef STEP
+
+    uint32_t t = state[1] + cl + dr;
+    state[1] = state[2] + dl + er;
+    state[2] = state[3] + el + ar;
+    state[3] = state[4] + al + br;
+    state[4] = state[0] + bl + cr;
+    state[0] = t;
+}
+
+#define LANES RIPEMD160_LANES
+
+void RIPEMD160TransformLanes(uint32_t state[5][RIPEMD160_LANES], const uint32_t x[16][RIPEMD160_LANES]) {
+    uint32_t al[LANES], bl[LANES], cl[LANES], dl[LANES], el[LANES];
+    uint32_t ar[LANES], br[LANES], cr[LANES], dr[LANES], er[LANES];
+
+    memcpy(al, state[0], sizeof(al));
+    memcpy(bl, state[1], sizeof(bl));
+    memcpy(cl, state[2], sizeof(cl));
+    memcpy(dl, state[3], sizeof(dl));
+    memcpy(el, state[4], sizeof(el));
+    memcpy(ar, al, sizeof(ar));
+    memcpy(br, bl, sizeof(br));
+    memcpy(cr, cl, sizeof(cr));
+    memcpy(dr, dl, sizeof(dr));
+    memcpy(er, el, sizeof(er));
+
+    // Same step list, each step a loop over lanes
+#define STEP(F, a, b, c, d, e, r, s, k) \
+    for (int l = 0; l < LANES; ++l) { \
+        a[l] = ROL(a[l] + F(b[l], c[l], d[l]) + x[r][l] + k, s) + e[l]; \
+        c[l] = ROL(c[l], 10); \
+    }
+
+    RIPEMD160_STEPS(STEP)
+#undef STEP
+
+    for (int l = 0; l < LANES; ++l) {
+        uint32_t t = state[1][l] + cl[l] + dr[l];
+        state[1][l] = state[2][l] + dl[l] + er[l];
+        state[2][l] = state[3][l] + el[l] + ar[l];
+        state[3][l] = state[4][l] + al[l] + br[l];
+        state[4][l] = state[0][l] + bl[l] + cr[l];
+        state[0][l] = t;
+    }
+}
+
+RIPEMD160::RIPEMD160() {
+    Init();
+}
+
+void RIPEMD160::Init() {
+    for (int i = 0; i < 5; ++i) {
+        state[i] = RIPEMD160_IV[i];
+    }
+    count = 0;
+}
+
+void RIPEMD160::Transform(const uint8_t* data) {
+    uint32_t x[16];
+
+    // RIPEMD-160 reads message words little-endian
+    for (int i = 0, j = 0; i < 16; ++i, j += 4) {
+        x[i] = (uint32_t)data[j] | ((uint32_t)data[j + 1] << 8) |
+               ((uint32_t)data[j + 2] << 16) | ((uint32_t)data[j + 3] << 24);
+    }
+    RIPEMD160TransformWords(state, x);
+}
+
+void RIPEMD160::Update(const uint8_t* data, size_t len) {
+    size_t i = 0;
+    size_t bufferSpace = 64 - (count % 64);
+
+    count += len;
+
+    if (len >= bufferSpace) {
+        // Fill buffer and process it
+        memcpy(buffer + (64 - bufferSpace), data, bufferSpace);
+        Transform(buffer);
+
+        // Process full blocks
+        for (i = bufferSpace; i + 64 <= len; i += 64) {
+            Transform(data + i);
+        }
+
+        bufferSpace = 64;
+    }
+
+    // Store remaining data in buffer
+    memcpy(buffer + (64 - bufferSpace), data + i, len - i);
+}
+
+void RIPEMD160::Final(uint8_t* hash) {
+    size_t i = count % 64;
+
+    // Pad with 0x80 followed by zeros
+    buffer[i++] = 0x80;
+
+    if (i > 56) {
+        // Not enough space for length, need extra block
+        memset(buffer + i, 0, 64 - i);
+        Transform(buffer);
+        i = 0;
+    }
+
+    memset(buffer + i, 0, 56 - i);
+
+    // Append length in bits as little-endian 64-bit integer
+    uint64_t bitCount = count * 8;
+    for (int j = 0; j < 8; ++j) {
+        buffer[56 + j] = bitCount & 0xff;
+        bitCount >>= 8;
+    }
+
+    Transform(buffer);
+
+    // Produce final hash value (little-endian)
+    for (int i = 0; i < 5; ++i) {
+        hash[i * 4] = state[i] & 0xff;
+        hash[i * 4 + 1] = (state[i] >> 8) & 0xff;
+        hash[i * 4 + 2] = (state[i] >> 16) & 0xff;
+        hash[i * 4 + 3] = (state[i] >> 24) & 0xff;
+    }
+}
+
+void RIPEMD160::Hash(const uint8_t* data, size_t len, uint8_t* hash) {
+    RIPEMD160 ripemd;
+    ripemd.Update(data, len);
+    ripemd.Final(hash);
+}
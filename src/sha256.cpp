@@ -4,16 +4,9 @@
  */
 
 #include "sha256.h"
+#include "sha256_core.h"
 
-#define ROR(x, n) (((x) >> (n)) | ((x) << (32 - (n))))
-#define CH(x, y, z) (((x) & (y)) ^ (~(x) & (z)))
-#define MAJ(x, y, z) (((x) & (y)) ^ ((x) & (z)) ^ ((y) & (z)))
-#define EP0(x) (ROR(x, 2) ^ ROR(x, 13) ^ ROR(x, 22))
-#define EP1(x) (ROR(x, 6) ^ ROR(x, 11) ^ ROR(x, 25))
-#define SIG0(x) (ROR(x, 7) ^ ROR(x, 18) ^ ((x) >> 3))
-#define SIG1(x) (ROR(x, 17) ^ ROR(x, 19) ^ ((x) >> 10))
-
-static const uint32_t K[64] = {
+const uint32_t SHA256_K[64] = {
     0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
     0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
     0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
@@ -24,66 +17,27 @@ static const uint32_t K[64] = {
     0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
 };
 
+const uint32_t SHA256_IV[8] = {
+    0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+};
+
+const uint32_t SHA224_IV[8] = {
+    0xc1059ed8, 0x367cd507, 0x3070dd17, 0xf70e5939, 0xffc00b31, 0x68581511, 0x64f98fa7, 0xbefa4fa4
+};
+
 SHA256::SHA256() {
     Init();
 }
 
 void SHA256::Init() {
-    state[0] = 0x6a09e667;
-    state[1] = 0xbb67ae85;
-    state[2] = 0x3c6ef372;
-    state[3] = 0xa54ff53a;
-    state[4] = 0x510e527f;
-    state[5] = 0x9b05688c;
-    state[6] = 0x1f83d9ab;
-    state[7] = 0x5be0cd19;
+    for (int i = 0; i < 8; ++i) {
+        state[i] = SHA256_IV[i];
+    }
     count = 0;
 }
 
 void SHA256::Transform(const uint8_t* data) {
-    uint32_t a, b, c, d, e, f, g, h, t1, t2, m[64];
-    
-    // Prepare message schedule
-    for (int i = 0, j = 0; i < 16; ++i, j += 4) {
-        m[i] = (data[j] << 24) | (data[j + 1] << 16) | (data[j + 2] << 8) | (data[j + 3]);
-    }
-    for (int i = 16; i < 64; ++i) {
-        m[i] = SIG1(m[i - 2]) + m[i - 7] + SIG0(m[i - 15]) + m[i - 16];
-    }
-    
-    // Initialize working variables
-    a = state[0];
-    b = state[1];
-    c = state[2];
-    d = state[3];
-    e = state[4];
-    f = state[5];
-    g = state[6];
-    h = state[7];
-    
-    // Main loop
-    for (int i = 0; i < 64; ++i) {
-        t1 = h + EP1(e) + CH(e, f, g) + K[i] + m[i];
-        t2 = EP0(a) + MAJ(a, b, c);
-        h = g;
-        g = f;
-        f = e;
-        e = d + t1;
-        d = c;
-        c = b;
-        b = a;
-        a = t1 + t2;
-    }
-    
-    // Add compressed chunk to current hash value
-    state[0] += a;
-    state[1] += b;
-    state[2] += c;
-    state[3] += d;
-    state[4] += e;
-    state[5] += f;
-    state[6] += g;
-    state[7] += h;
+    SHA256CoreTransformBytes(state, data);
 }
 
 void SHA256::Update(const uint8_t* data, size_t len) {
@@ -109,7 +63,45 @@ void SHA256::Update(const uint8_t* data, size_t len) {
     memcpy(buffer + (64 - bufferSpace), data + i, len - i);
 }
 
-void SHA256::Final(uint8_t* hash) {
+void SHA256::UpdateV(const SHA256Fragment* fragments, size_t num) {
+    size_t used = count % 64;
+    
+    for (size_t f = 0; f < num; ++f) {
+        const uint8_t* data = fragments[f].data;
+        size_t len = fragments[f].len;
+        if (len == 0) {
+            continue;
+        }
+        count += len;
+        
+        // Complete the block carried over from earlier fragments
+        if (used > 0) {
+            size_t n = len < 64 - used ? len : 64 - used;
+            memcpy(buffer + used, data, n);
+            used += n;
+            if (used < 64) {
+                continue;
+            }
+            Transform(buffer);
+            data += n;
+            len -= n;
+            used = 0;
+        }
+        
+        // Process full blocks in place
+        for (; len >= 64; data += 64, len -= 64) {
+            Transform(data);
+        }
+        
+        // Carry the tail into the next fragment
+        if (len > 0) {
+            memcpy(buffer, data, len);
+            used = len;
+        }
+    }
+}
+
+void SHA256::Pad() {
     size_t i = count % 64;
     
     // Pad with 0x80 followed by zeros
@@ -132,6 +124,10 @@ void SHA256::Final(uint8_t* hash) {
     }
     
     Transform(buffer);
+}
+
+void SHA256::Final(uint8_t* hash) {
+    Pad();
     
     // Produce final hash value (big-endian)
     for (int i = 0; i < 8; ++i) {
@@ -142,8 +138,96 @@ void SHA256::Final(uint8_t* hash) {
     }
 }
 
+void SHA256::FinalWords(uint32_t hash[8]) {
+    Pad();
+    
+    for (int i = 0; i < 8; ++i) {
+        hash[i] = state[i];
+    }
+}
+
+void SHA256::Midstate(uint32_t out[8]) const {
+    for (int i = 0; i < 8; ++i) {
+        out[i] = state[i];
+    }
+}
+
+void SHA256::SetMidstate(const uint32_t in[8], uint64_t len) {
+    for (int i = 0; i < 8; ++i) {
+        state[i] = in[i];
+    }
+    count = len;
+}
+
+static const uint8_t SAVED_MAGIC[4] = {'S', '2', '5', '6'};
+
+void SHA256::Save(uint8_t out[SHA256_SAVED_BYTES]) const {
+    size_t used = count % 64;
+    
+    memset(out, 0, SHA256_SAVED_BYTES);
+    memcpy(out, SAVED_MAGIC, 4);
+    out[4] = SHA256_SAVED_VERSION;
+    out[5] = (uint8_t)used;
+    WriteBE32(out + 8, (uint32_t)(count >> 32));
+    WriteBE32(out + 12, (uint32_t)count);
+    for (int i = 0; i < 8; ++i) {
+        WriteBE32(out + 16 + i * 4, state[i]);
+    }
+    memcpy(out + 48, buffer, used);
+}
+
+bool SHA256::Restore(const uint8_t in[SHA256_SAVED_BYTES]) {
+    if (memcmp(in, SAVED_MAGIC, 4) != 0 || in[4] != SHA256_SAVED_VERSION || in[6] != 0 || in[7] != 0) {
+        return false;
+    }
+    uint64_t saved_count = ((uint64_t)ReadBE32(in + 8) << 32) | ReadBE32(in + 12);
+    if (in[5] != saved_count % 64) {
+        return false;
+    }
+    
+    // Canonical records only: the fill after the tail is zero
+    for (size_t i = 48 + in[5]; i < SHA256_SAVED_BYTES; ++i) {
+        if (in[i] != 0) {
+            return false;
+        }
+    }
+    
+    for (int i = 0; i < 8; ++i) {
+        state[i] = ReadBE32(in + 16 + i * 4);
+    }
+    count = saved_count;
+    memcpy(buffer, in + 48, in[5]);
+    return true;
+}
+
 void SHA256::Hash(const uint8_t* data, size_t len, uint8_t* hash) {
     SHA256 sha;
     sha.Update(data, len);
     sha.Final(hash);
 }
+
+SHA224::SHA224() {
+    Init();
+}
+
+void SHA224::Init() {
+    sha.SetMidstate(SHA224_IV, 0);
+}
+
+void SHA224::Update(const uint8_t* data, size_t len) {
+    sha.Update(data, len);
+}
+
+void SHA224::Final(uint8_t* hash) {
+    uint32_t words[8];
+    sha.FinalWords(words);
+    for (int i = 0; i < 7; ++i) {
+        WriteBE32(hash + i * 4, words[i]);
+    }
+}
+
+void SHA224::Hash(const uint8_t* data, size_t len, uint8_t* hash) {
+    SHA224 sha;
+    sha.Update(data, len);
+    sha.Final(hash);
+}
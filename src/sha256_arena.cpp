@@ -0,0 +1,82 @@
+/*
+ * Packed variable-length batches for HASH256_PTX
+ */
+
+#include "sha256_arena.h"
+#include "sha256_core.h"
+#include <algorithm>
+
+bool SHA256ArenaPack(SHA256Arena& arena, const uint8_t* const* msgs, const size_t* lens, size_t count) {
+    if (count > 0xffffffffu) {
+        return false;
+    }
+    size_t total = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (lens[i] > SHA256_ARENA_MAX_MESSAGE) {
+            return false;
+        }
+        total += lens[i];
+    }
+
+    // Bucket by block count; stable, so equal counts keep the caller's order
+    std::vector<uint32_t> order(count);
+    for (size_t i = 0; i < count; ++i) {
+        order[i] = (uint32_t)i;
+    }
+    std::stable_sort(order.begin(), order.end(), [lens](uint32_t x, uint32_t y) {
+        return SHA256BlockCount(lens[x]) < SHA256BlockCount(lens[y]);
+    });
+
+    // Lay the bytes out in the same order, so neighbouring threads read
+    // neighbouring messages
+    arena.bytes.resize(total);
+    arena.entries.resize(count);
+    uint64_t offset = 0;
+    for (size_t i = 0; i < count; ++i) {
+        uint32_t m = order[i];
+        if (lens[m]) {
+            memcpy(&arena.bytes[offset], msgs[m], lens[m]);
+        }
+        arena.entries[i].offset = offset;
+        arena.entries[i].length = (uint32_t)lens[m];
+        arena.entries[i].index = m;
+        offset += lens[m];
+    }
+    return true;
+}
+
+// One arena thread: whole blocks straight from the message, then the tail
+// blocks built byte by byte with the padding
+static void HashEntry(const uint8_t* msg, uint32_t len, uint8_t hash[32]) {
+    uint32_t state[8], block[16];
+    memcpy(state, SHA256_IV, sizeof(state));
+
+    uint64_t end = SHA256BlockCount(len) * 64;
+    for (uint64_t pos = 0; pos < end; pos += 64) {
+        if (pos + 64 <= len) {
+            SHA256CoreTransformBytes(state, msg + pos);
+            continue;
+        }
+        memset(block, 0, sizeof(block));
+        for (int k = 0; k < 64; ++k) {
+            uint64_t p = pos + k;
+            uint32_t byte = p < len ? msg[p] : p == len ? 0x80 : 0;
+            block[k / 4] |= byte << (24 - 8 * (k % 4));
+        }
+        if (pos + 64 == end) {
+            block[14] = len >> 29;
+            block[15] = len << 3;
+        }
+        SHA256CoreTransform(state, block);
+    }
+    for (int i = 0; i < 8; ++i) {
+        WriteBE32(hash + i * 4, state[i]);
+    }
+}
+
+void SHA256ArenaHash(const SHA256Arena& arena, uint8_t* hashes) {
+    for (size_t i = 0; i < arena.entries.size(); ++i) {
+        const SHA256ArenaEntry& entry = arena.entries[i];
+        HashEntry(arena.bytes.data() + entry.offset, entry.length, hashes + (size_t)entry.index * 32);
+    }
+}
@@ -0,0 +1,219 @@
+/*
+ * Mixed-length SHA256 batches for HASH256_PTX
+ */
+
+#include "sha256_batch.h"
+#include "sha256_arena.h"
+#include "sha256_lanes.h"
+#include "sha256_ops.h"
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+// Below this many blocks per thread a batch is hashed on the calling thread
+static const uint64_t BATCH_MIN_BLOCKS_PER_THREAD = 4096;
+
+// Big-endian words of the lane's next block into column l: straight from
+// the message while whole blocks remain, then the tail with its padding
+static void LoadBlock(uint32_t block[16][SHA256_LANES], int l, const SHA256LaneJob& lane) {
+    if (lane.pos + 64 <= lane.len) {
+        for (int i = 0; i < 16; ++i) {
+            block[i][l] = ReadBE32(lane.msg + lane.pos + i * 4);
+        }
+        return;
+    }
+    uint8_t buf[64] = {0};
+    if (lane.pos <= lane.len) {
+        size_t n = (size_t)(lane.len - lane.pos);
+        memcpy(buf, lane.msg + lane.pos, n);
+        buf[n] = 0x80;
+    }
+    if (lane.pos + 64 == lane.end) {
+        uint64_t bits = lane.len * 8;
+        WriteBE32(buf + 56, (uint32_t)(bits >> 32));
+        WriteBE32(buf + 60, (uint32_t)bits);
+    }
+    for (int i = 0; i < 16; ++i) {
+        block[i][l] = ReadBE32(buf + i * 4);
+    }
+}
+
+static void StartLane(uint32_t state[8][SHA256_LANES], SHA256LaneJob& lane, int l, const uint8_t* msg,
+                      size_t len, uint8_t* hash) {
+    lane.msg = msg;
+    lane.len = len;
+    lane.pos = 0;
+    lane.end = SHA256BlockCount(len) * 64;
+    lane.hash = hash;
+    for (int i = 0; i < 8; ++i) {
+        state[i][l] = SHA256_IV[i];
+    }
+}
+
+// One compression of every busy lane. Lanes whose message ends write the
+// digest and go idle; returns them as a bit mask.
+static unsigned StepLanes(uint32_t state[8][SHA256_LANES], uint32_t block[16][SHA256_LANES],
+                          SHA256LaneJob lanes[SHA256_LANES]) {
+    // Idle lanes compress whatever their columns hold; it is discarded
+    for (int l = 0; l < SHA256_LANES; ++l) {
+        if (lanes[l].hash) {
+            LoadBlock(block, l, lanes[l]);
+        }
+    }
+    SHA256TransformLanes(state, block);
+
+    unsigned finished = 0;
+    for (int l = 0; l < SHA256_LANES; ++l) {
+        if (!lanes[l].hash) {
+            continue;
+        }
+        lanes[l].pos += 64;
+        if (lanes[l].pos == lanes[l].end) {
+            for (int i = 0; i < 8; ++i) {
+                WriteBE32(lanes[l].hash + i * 4, state[i][l]);
+            }
+            lanes[l].hash = NULL;
+            finished |= 1u << l;
+        }
+    }
+    return finished;
+}
+
+// Hash the messages order[0..count-1], refilling each lane from the queue
+// as its message completes
+static void HashQueue(const uint8_t* const* msgs, const size_t* lens, const uint32_t* order, size_t count,
+                      uint8_t* hashes) {
+    uint32_t state[8][SHA256_LANES] = {};
+    uint32_t block[16][SHA256_LANES] = {};
+    SHA256LaneJob lanes[SHA256_LANES];
+    size_t next = 0;
+    int active = 0;
+
+    for (int l = 0; l < SHA256_LANES; ++l) {
+        lanes[l].hash = NULL;
+    }
+    for (;;) {
+        for (int l = 0; l < SHA256_LANES && next < count; ++l) {
+            if (!lanes[l].hash) {
+                uint32_t m = order[next++];
+                StartLane(state, lanes[l], l, msgs[m], lens[m], hashes + (size_t)m * 32);
+                ++active;
+            }
+        }
+        if (active == 0) {
+            break;
+        }
+        unsigned finished = StepLanes(state, block, lanes);
+        for (; finished; finished &= finished - 1) {
+            --active;
+        }
+    }
+}
+
+void SHA256HashBatch(const uint8_t* const* msgs, const size_t* lens, size_t count, uint8_t* hashes,
+                     unsigned num_threads) {
+    if (count == 0) {
+        return;
+    }
+    if (num_threads == 0) {
+        num_threads = std::thread::hardware_concurrency();
+        if (num_threads == 0) {
+            num_threads = 1;
+        }
+    }
+
+    // Bucket by block count, longest first; stable so equal counts keep
+    // their order
+    std::vector<uint32_t> order(count);
+    uint64_t total_blocks = 0;
+    for (size_t i = 0; i < count; ++i) {
+        order[i] = (uint32_t)i;
+        total_blocks += SHA256BlockCount(lens[i]);
+    }
+    std::stable_sort(order.begin(), order.end(), [lens](uint32_t x, uint32_t y) {
+        return SHA256BlockCount(lens[x]) > SHA256BlockCount(lens[y]);
+    });
+
+    uint64_t max_threads = total_blocks / BATCH_MIN_BLOCKS_PER_THREAD;
+    if (num_threads > max_threads) {
+        num_threads = max_threads ? (unsigned)max_threads : 1;
+    }
+
+    // Contiguous shares of the queue with about total_blocks / num_threads
+    // blocks each; the calling thread takes the first
+    std::vector<size_t> bounds(1, 0);
+    uint64_t blocks = 0;
+    for (size_t i = 0; i + 1 < count && bounds.size() < num_threads; ++i) {
+        blocks += SHA256BlockCount(lens[order[i]]);
+        if (blocks * num_threads >= total_blocks * bounds.size()) {
+            bounds.push_back(i + 1);
+        }
+    }
+    bounds.push_back(count);
+
+    std::vector<std::thread> workers;
+    for (size_t t = 1; t + 1 < bounds.size(); ++t) {
+        workers.push_back(std::thread(HashQueue, msgs, lens, &order[bounds[t]], bounds[t + 1] - bounds[t], hashes));
+    }
+    HashQueue(msgs, lens, &order[0], bounds[1], hashes);
+    for (size_t t = 0; t < workers.size(); ++t) {
+        workers[t].join();
+    }
+}
+
+SHA256JobManager::SHA256JobManager() : busy(0), num_done(0) {
+    memset(state, 0, sizeof(state));
+    memset(block, 0, sizeof(block));
+    for (int l = 0; l < SHA256_LANES; ++l) {
+        lanes[l].hash = NULL;
+        jobs[l] = NULL;
+    }
+}
+
+void SHA256JobManager::Run() {
+    unsigned finished = 0;
+    while (!finished) {
+        finished = StepLanes(state, block, lanes);
+    }
+    // At most SHA256_LANES jobs wait in done: Run only starts with done
+    // empty
+    for (int l = 0; l < SHA256_LANES; ++l) {
+        if (finished & (1u << l)) {
+            done[num_done++] = jobs[l];
+            jobs[l] = NULL;
+            --busy;
+        }
+    }
+}
+
+SHA256Job* SHA256JobManager::Submit(SHA256Job* job) {
+    // A lane is always free here: the last submit that filled them ran
+    // until one completed
+    int l = 0;
+    while (lanes[l].hash) {
+        ++l;
+    }
+    StartLane(state, lanes[l], l, job->msg, job->len, job->hash);
+    jobs[l] = job;
+    if (++busy == SHA256_LANES) {
+        Run();
+    }
+    return num_done ? PopDone() : NULL;
+}
+
+SHA256Job* SHA256JobManager::Flush() {
+    if (num_done == 0) {
+        if (busy == 0) {
+            return NULL;
+        }
+        Run();
+    }
+    return PopDone();
+}
+
+SHA256Job* SHA256JobManager::PopDone() {
+    SHA256Job* job = done[0];
+    --num_done;
+    memmove(done, done + 1, num_done * sizeof(done[0]));
+    return job;
+}
@@ -0,0 +1,118 @@
+/*
+ * Digest layout helpers for HASH256_PTX
+ * SIMD paths are selected at compile time (AVX2, then SSSE3/SSE2, then scalar)
+ */
+
+#include "sha256_digest.h"
+#include "sha256_ops.h"
+
+#if defined(__AVX2__) || defined(__SSSE3__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+static void ByteSwapWords(const uint8_t* in, uint8_t* out, size_t num_words) {
+    size_t i = 0;
+#if defined(__AVX2__)
+    const __m256i shuffle = _mm256_setr_epi8(
+        3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12,
+        3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+    for (; i + 8 <= num_words; i += 8) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(in + i * 4));
+        _mm256_storeu_si256((__m256i*)(out + i * 4), _mm256_shuffle_epi8(v, shuffle));
+    }
+#elif defined(__SSSE3__)
+    const __m128i shuffle = _mm_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+    for (; i + 4 <= num_words; i += 4) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(in + i * 4));
+        _mm_storeu_si128((__m128i*)(out + i * 4), _mm_shuffle_epi8(v, shuffle));
+    }
+#elif defined(__SSE2__)
+    for (; i + 4 <= num_words; i += 4) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(in + i * 4));
+        // Swap bytes within 16-bit halves, then swap the halves
+        v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+        v = _mm_shufflelo_epi16(v, 0xB1);
+        v = _mm_shufflehi_epi16(v, 0xB1);
+        _mm_storeu_si128((__m128i*)(out + i * 4), v);
+    }
+#endif
+    for (; i < num_words; ++i) {
+        uint32_t w;
+        memcpy(&w, in + i * 4, 4);
+        w = Bswap32(w);
+        memcpy(out + i * 4, &w, 4);
+    }
+}
+
+void DigestWordsToBytes(const uint32_t* words, uint8_t* bytes, size_t count) {
+    ByteSwapWords((const uint8_t*)words, bytes, count * 8);
+}
+
+void DigestBytesToWords(const uint8_t* bytes, uint32_t* words, size_t count) {
+    ByteSwapWords(bytes, (uint8_t*)words, count * 8);
+}
+
+// Bit i set when word i of a and b are equal
+static inline uint32_t EqualWordMask(const uint32_t* a, const uint32_t* b) {
+#if defined(__AVX2__)
+    __m256i va = _mm256_loadu_si256((const __m256i*)a);
+    __m256i vb = _mm256_loadu_si256((const __m256i*)b);
+    return (uint32_t)_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(va, vb)));
+#elif defined(__SSE2__)
+    __m128i lo = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)a), _mm_loadu_si128((const __m128i*)b));
+    __m128i hi = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)(a + 4)), _mm_loadu_si128((const __m128i*)(b + 4)));
+    return (uint32_t)_mm_movemask_ps(_mm_castsi128_ps(lo)) |
+           ((uint32_t)_mm_movemask_ps(_mm_castsi128_ps(hi)) << 4);
+#else
+    uint32_t mask = 0;
+    for (int i = 0; i < 8; ++i) {
+        mask |= (uint32_t)(a[i] == b[i]) << i;
+    }
+    return mask;
+#endif
+}
+
+bool DigestWordsEqual(const uint32_t* a, const uint32_t* b) {
+    return EqualWordMask(a, b) == 0xff;
+}
+
+int DigestWordsCompare(const uint32_t* a, const uint32_t* b) {
+    uint32_t diff = ~EqualWordMask(a, b) & 0xff;
+    if (diff == 0) {
+        return 0;
+    }
+    int i = 0;
+    while (!(diff & 1)) {
+        diff >>= 1;
+        ++i;
+    }
+    return a[i] < b[i] ? -1 : 1;
+}
+
+size_t DigestWordsFind(const uint32_t* digests, size_t count, const uint32_t* target,
+                       uint32_t* indices, size_t max_indices) {
+    size_t found = 0;
+#if defined(__AVX2__)
+    const __m256i vt = _mm256_loadu_si256((const __m256i*)target);
+    for (size_t i = 0; i < count; ++i) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(digests + i * 8));
+        if (_mm256_testc_si256(_mm256_cmpeq_epi32(v, vt), _mm256_set1_epi32(-1))) {
+            if (found < max_indices) {
+                indices[found] = (uint32_t)i;
+            }
+            found++;
+        }
+    }
+#else
+    for (size_t i = 0; i < count; ++i) {
+        // Cheap first-word reject before the full comparison
+        if (digests[i * 8] == target[0] && DigestWordsEqual(digests + i * 8, target)) {
+            if (found < max_indices) {
+                indices[found] = (uint32_t)i;
+            }
+            found++;
+        }
+    }
+#endif
+    return found;
+}
@@ -0,0 +1,226 @@
+/*
+ * Lane-parallel SHA256 for HASH256_PTX
+ * The rounds are the shared core (sha256_core.h) on one vector per word,
+ * SHA256_LANES wide; the arrays of the API are that vector's memory image
+ */
+
+#include "sha256_lanes.h"
+#include "sha256_core.h"
+#include "sha256_shapes.h"
+
+#define LANES SHA256_LANES
+
+// One AVX2 register per word, or two SSE2 registers
+#ifdef __AVX2__
+typedef SHA256Vec8 LaneVec;
+#else
+typedef SHA256VecPair<SHA256Vec4> LaneVec;
+#endif
+
+static_assert(sizeof(LaneVec) == LANES * sizeof(uint32_t), "one vector per word across all lanes");
+
+static inline void Load(LaneVec* v, const uint32_t (*rows)[LANES], int n) {
+    memcpy(v, rows, n * sizeof(LaneVec));
+}
+
+static inline void Store(uint32_t (*rows)[LANES], const LaneVec* v, int n) {
+    memcpy(rows, v, n * sizeof(LaneVec));
+}
+
+static inline LaneVec Broadcast(uint32_t x) {
+    LaneVec v = {};
+    v += x;
+    return v;
+}
+
+void SHA256TransformLanes(uint32_t state[8][SHA256_LANES], const uint32_t block[16][SHA256_LANES]) {
+    LaneVec st[8], w[16];
+    Load(st, state, 8);
+    Load(w, block, 16);
+    SHA256CoreTransform(st, w);
+    Store(state, st, 8);
+}
+
+uint32_t SHA256TransformLanesMatch(uint32_t state[8][SHA256_LANES], const uint32_t block[16][SHA256_LANES],
+                                   SHA256LaneTest test, const void* ctx) {
+    LaneVec st[8], s[8], w[16];
+    Load(st, state, 8);
+    Load(w, block, 16);
+    memcpy(s, st, sizeof(s));
+
+    // Rounds 0..60. The slot round 60 wrote its new e to (7) and the one it
+    // wrote its new a to (3) are only shifted by the last three rounds, into
+    // the final h and d, so H7 and H3 are known now.
+    SHA256CoreRolling<LaneVec> source = {w};
+    SHA256CoreRounds<0, 61>(s, source);
+    LaneVec h7 = st[7] + s[7], h3 = st[3] + s[3];
+    uint32_t accepted = 0;
+    for (int l = 0; l < LANES; ++l) {
+        if (test(h7[l], h3[l], ctx)) {
+            accepted |= 1u << l;
+        }
+    }
+    if (!accepted) {
+        return 0;
+    }
+
+    SHA256CoreRounds<61, 64>(s, source);
+    for (int i = 0; i < 8; ++i) {
+        st[i] += s[i];
+    }
+    Store(state, st, 8);
+    return accepted;
+}
+
+// Schedule words prefix.rounds..63. Fixed words are broadcast; varying ones
+// add their varying terms to the precomputed fixed part. The tests are per
+// word, not per lane.
+static void ExpandPrefixSchedule(const SHA256Prefix& prefix, const uint32_t block[16][LANES], LaneVec w[64]) {
+    const uint64_t varying = prefix.varying;
+
+    for (uint32_t i = prefix.rounds; i < 16; ++i) {
+        if ((varying >> i) & 1) {
+            Load(&w[i], &block[i], 1);
+        } else {
+            w[i] = Broadcast(prefix.schedule[i]);
+        }
+    }
+    for (int i = 16; i < 64; ++i) {
+        w[i] = Broadcast(prefix.schedule[i]);
+        if (!((varying >> i) & 1)) {
+            continue;
+        }
+        if ((varying >> (i - 2)) & 1) {
+            w[i] += SIG1(w[i - 2]);
+        }
+        if ((varying >> (i - 7)) & 1) {
+            w[i] += w[i - 7];
+        }
+        if ((varying >> (i - 15)) & 1) {
+            w[i] += SIG0(w[i - 15]);
+        }
+        if ((varying >> (i - 16)) & 1) {
+            w[i] += w[i - 16];
+        }
+    }
+}
+
+void SHA256TransformLanesPrefix(const SHA256Prefix& prefix, const uint32_t block[16][SHA256_LANES],
+                                uint32_t out[8][SHA256_LANES]) {
+    LaneVec w[64], s[8];
+    ExpandPrefixSchedule(prefix, block, w);
+    for (int i = 0; i < 8; ++i) {
+        s[i] = Broadcast(prefix.state[i]);
+    }
+
+    // Single rounds up to the next multiple of 8 (prefix.rounds is at most
+    // 16), then the unrolled rest from there
+    uint32_t i = prefix.rounds;
+    for (; i & 7; ++i) {
+        SHA256CoreRoundShift(s, w[i] + SHA256_K[i]);
+    }
+    SHA256CoreExpanded<LaneVec> source = {w};
+    if (i == 0) {
+        SHA256CoreRounds<0, 64>(s, source);
+    } else if (i == 8) {
+        SHA256CoreRounds<8, 64>(s, source);
+    } else {
+        SHA256CoreRounds<16, 64>(s, source);
+    }
+
+    for (int j = 0; j < 8; ++j) {
+        s[j] += prefix.init[j];
+    }
+    Store(out, s, 8);
+}
+
+void SHA256TransformLanesPrefixChained(const SHA256Prefix& prefix, const uint32_t init[8][SHA256_LANES],
+                                       const uint32_t block[16][SHA256_LANES], uint32_t out[8][SHA256_LANES]) {
+    LaneVec w[64], st[8], s[8];
+
+    // The whole block is read here, so out may alias block
+    ExpandPrefixSchedule(prefix, block, w);
+    Load(st, init, 8);
+    memcpy(s, st, sizeof(s));
+
+    SHA256CoreExpanded<LaneVec> source = {w};
+    SHA256CoreRounds<0, 64>(s, source);
+
+    for (int i = 0; i < 8; ++i) {
+        s[i] += st[i];
+    }
+    Store(out, s, 8);
+}
+
+void SHA256Hash64Lanes(const uint32_t block[16][SHA256_LANES], uint32_t out[8][SHA256_LANES]) {
+    LaneVec st[8], w[16];
+    for (int i = 0; i < 8; ++i) {
+        st[i] = Broadcast(SHA256_IV[i]);
+    }
+    Load(w, block, 16);
+    SHA256ShapeNode64(st, w);
+    Store(out, st, 8);
+}
+
+void SHA256HashLanes(const uint32_t init[8], uint64_t prefix_len,
+                     const uint8_t* const data[SHA256_LANES], size_t len,
+                     uint32_t out[8][SHA256_LANES]) {
+    uint32_t block[16][LANES];
+
+    // A whole 33-byte message (a compressed key) has a generated transform
+    if (prefix_len == 0 && len == SHA256_SHAPE_KEY33_BYTES) {
+        uint32_t words[SHA256_SHAPE_KEY33_DATA_WORDS][LANES];
+        LaneVec st[8], w[SHA256_SHAPE_KEY33_DATA_WORDS];
+        for (int l = 0; l < LANES; ++l) {
+            for (int i = 0; i < 8; ++i) {
+                words[i][l] = ReadBE32(data[l] + i * 4);
+            }
+            words[8][l] = (uint32_t)data[l][32] << 24;
+        }
+        for (int i = 0; i < 8; ++i) {
+            st[i] = Broadcast(init[i]);
+        }
+        Load(w, words, SHA256_SHAPE_KEY33_DATA_WORDS);
+        SHA256ShapeKey33(st, w);
+        Store(out, st, 8);
+        return;
+    }
+
+    for (int i = 0; i < 8; ++i) {
+        for (int l = 0; l < LANES; ++l) {
+            out[i][l] = init[i];
+        }
+    }
+
+    // Full blocks straight from the inputs
+    size_t offset = 0;
+    for (; offset + 64 <= len; offset += 64) {
+        for (int l = 0; l < LANES; ++l) {
+            for (int i = 0; i < 16; ++i) {
+                block[i][l] = ReadBE32(data[l] + offset + i * 4);
+            }
+        }
+        SHA256TransformLanes(out, block);
+    }
+
+    // Tail plus padding: one block, or two when the length does not fit
+    size_t tail = len - offset;
+    size_t tail_blocks = tail < 56 ? 1 : 2;
+    uint64_t bit_count = (prefix_len + len) * 8;
+    uint8_t padded[LANES][128];
+    for (int l = 0; l < LANES; ++l) {
+        memcpy(padded[l], data[l] + offset, tail);
+        padded[l][tail] = 0x80;
+        memset(padded[l] + tail + 1, 0, tail_blocks * 64 - tail - 1);
+        WriteBE32(padded[l] + tail_blocks * 64 - 8, (uint32_t)(bit_count >> 32));
+        WriteBE32(padded[l] + tail_blocks * 64 - 4, (uint32_t)bit_count);
+    }
+    for (size_t blk = 0; blk < tail_blocks; ++blk) {
+        for (int l = 0; l < LANES; ++l) {
+            for (int i = 0; i < 16; ++i) {
+                block[i][l] = ReadBE32(padded[l] + blk * 64 + i * 4);
+            }
+        }
+        SHA256TransformLanes(out, block);
+    }
+}
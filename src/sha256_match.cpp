@@ -0,0 +1,89 @@
+/*
+ * Match-mode SHA256 batches for HASH256_PTX
+ */
+
+#include "sha256_match.h"
+#include "sha256_lanes.h"
+#include "sha256_ops.h"
+
+// Block k of the padded message (num_blocks blocks in total)
+static void PaddedBlock(uint8_t out[64], const uint8_t* msg, size_t len, size_t k, size_t num_blocks) {
+    size_t begin = k * 64;
+    size_t n = 0;
+    if (len > begin) {
+        n = len - begin < 64 ? len - begin : 64;
+        memcpy(out, msg + begin, n);
+    }
+    memset(out + n, 0, 64 - n);
+    if (len >= begin && len < begin + 64) {
+        out[len - begin] = 0x80;
+    }
+    if (k == num_blocks - 1) {
+        uint64_t bit_count = (uint64_t)len * 8;
+        WriteBE32(out + 56, (uint32_t)(bit_count >> 32));
+        WriteBE32(out + 60, (uint32_t)bit_count);
+    }
+}
+
+static bool FilterKeyTest(uint32_t h7, uint32_t h3, const void* ctx) {
+    return static_cast<const TargetFilter*>(ctx)->MayContainKey(h7, h3);
+}
+
+static bool AcceptAll(uint32_t, uint32_t, const void*) {
+    return true;
+}
+
+size_t SHA256MatchBatch(const TargetFilter& filter, const uint8_t* data, size_t len, size_t count,
+                        TargetHit* hits, size_t max_hits) {
+    bool early = filter.Key() == TARGET_FILTER_KEY_H7H3;
+    size_t num_blocks = (len + 9 + 63) / 64;
+    uint32_t state[8][SHA256_LANES];
+    uint32_t block[16][SHA256_LANES];
+    uint8_t bytes[64];
+    size_t num_hits = 0;
+
+    for (size_t base = 0; base < count; base += SHA256_LANES) {
+        // A short final group repeats its last message in the spare lanes
+        size_t active = count - base < SHA256_LANES ? count - base : SHA256_LANES;
+        for (int i = 0; i < 8; ++i) {
+            for (int l = 0; l < SHA256_LANES; ++l) {
+                state[i][l] = SHA256_IV[i];
+            }
+        }
+
+        uint32_t accepted = 0;
+        for (size_t k = 0; k < num_blocks; ++k) {
+            for (size_t l = 0; l < SHA256_LANES; ++l) {
+                size_t n = l < active ? l : active - 1;
+                PaddedBlock(bytes, data + (base + n) * len, len, k, num_blocks);
+                for (int i = 0; i < 16; ++i) {
+                    block[i][l] = ReadBE32(bytes + i * 4);
+                }
+            }
+            if (k + 1 < num_blocks) {
+                SHA256TransformLanes(state, block);
+            } else {
+                accepted = SHA256TransformLanesMatch(state, block, early ? FilterKeyTest : AcceptAll, &filter);
+            }
+        }
+
+        for (size_t l = 0; l < active; ++l) {
+            if (!(accepted & (1u << l))) {
+                continue;
+            }
+            uint32_t digest[8];
+            for (int i = 0; i < 8; ++i) {
+                digest[i] = state[i][l];
+            }
+            if (!early && !filter.MayContain(digest)) {
+                continue;
+            }
+            if (num_hits < max_hits) {
+                hits[num_hits].index = (uint32_t)(base + l);
+                memcpy(hits[num_hits].digest, digest, sizeof(digest));
+            }
+            num_hits++;
+        }
+    }
+    return num_hits;
+}
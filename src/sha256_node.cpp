@@ -0,0 +1,62 @@
+/*
+ * Fixed 64-byte SHA256 for HASH256_PTX
+ */
+
+#include "sha256_node.h"
+#include "sha256_lanes.h"
+#include "sha256_ops.h"
+#include "sha256_shapes.h"
+
+// Second hash of SHA256d: a 32-byte message, data words 0..7 varying
+static SHA256Prefix MakeHash32Prefix() {
+    SHA256Prefix prefix;
+    SHA256PrefixInit(prefix, SHA256_IV, SHA256_SHAPE_DIGEST32_BLOCK0, SHA256_SHAPE_DIGEST32_VARYING0);
+    return prefix;
+}
+
+// Gather nodes base .. base + active - 1 into lane-major form
+static void LoadNodes(uint32_t block[16][SHA256_LANES], const uint32_t* children, size_t base, size_t active) {
+    // A short final group repeats its last node in the spare lanes
+    for (size_t l = 0; l < SHA256_LANES; ++l) {
+        const uint32_t* node = children + (base + (l < active ? l : active - 1)) * 16;
+        for (int i = 0; i < 16; ++i) {
+            block[i][l] = node[i];
+        }
+    }
+}
+
+static void StoreParents(uint32_t* parents, const uint32_t out[8][SHA256_LANES], size_t base, size_t active) {
+    for (size_t l = 0; l < active; ++l) {
+        for (int i = 0; i < 8; ++i) {
+            parents[(base + l) * 8 + i] = out[i][l];
+        }
+    }
+}
+
+void SHA256Node64Batch(const uint32_t* children, uint32_t* parents, size_t count) {
+    uint32_t block[16][SHA256_LANES];
+    uint32_t out[8][SHA256_LANES];
+
+    for (size_t base = 0; base < count; base += SHA256_LANES) {
+        size_t active = count - base < SHA256_LANES ? count - base : SHA256_LANES;
+        LoadNodes(block, children, base, active);
+        SHA256Hash64Lanes(block, out);
+        StoreParents(parents, out, base, active);
+    }
+}
+
+void SHA256dNode64Batch(const uint32_t* children, uint32_t* parents, size_t count) {
+    static const SHA256Prefix hash32 = MakeHash32Prefix();
+    uint32_t block[16][SHA256_LANES];
+    uint32_t digest_block[16][SHA256_LANES];
+    uint32_t out[8][SHA256_LANES];
+
+    for (size_t base = 0; base < count; base += SHA256_LANES) {
+        size_t active = count - base < SHA256_LANES ? count - base : SHA256_LANES;
+        LoadNodes(block, children, base, active);
+        // The first digest goes straight into the second hash's data words
+        SHA256Hash64Lanes(block, digest_block);
+        SHA256TransformLanesPrefix(hash32, digest_block, out);
+        StoreParents(parents, out, base, active);
+    }
+}
@@ -0,0 +1,93 @@
+/*
+ * Fixed-prefix SHA256 compression for HASH256_PTX
+ */
+
+#include "sha256_prefix.h"
+#include "sha256_core.h"
+
+// Rounds first..end-1 on the working variables v[0..7] = a..h
+static void Rounds(uint32_t v[8], const uint32_t w[64], uint32_t first, uint32_t end) {
+    for (uint32_t i = first; i < end; ++i) {
+        SHA256CoreRoundShift(v, SHA256_K[i] + w[i]);
+    }
+}
+
+static inline bool Varies(uint64_t varying, int t) {
+    return (varying >> t) & 1;
+}
+
+uint64_t SHA256PrefixVarying(uint32_t varying_words) {
+    uint64_t varying = varying_words & 0xffff;
+    for (int t = 16; t < 64; ++t) {
+        if (Varies(varying, t - 2) || Varies(varying, t - 7) ||
+            Varies(varying, t - 15) || Varies(varying, t - 16)) {
+            varying |= (uint64_t)1 << t;
+        }
+    }
+    return varying;
+}
+
+void SHA256PrefixInit(SHA256Prefix& prefix, const uint32_t init[8], const uint32_t block[16],
+                      uint32_t varying_words) {
+    prefix.varying_words = varying_words & 0xffff;
+    prefix.varying = SHA256PrefixVarying(prefix.varying_words);
+    prefix.rounds = 0;
+    while (prefix.rounds < 16 && !Varies(prefix.varying, prefix.rounds)) {
+        ++prefix.rounds;
+    }
+    memcpy(prefix.init, init, sizeof(prefix.init));
+
+    // Fixed words get their value; varying ones the sum of their fixed terms
+    uint32_t* w = prefix.schedule;
+    memcpy(w, block, 16 * sizeof(uint32_t));
+    for (int t = 16; t < 64; ++t) {
+        w[t] = 0;
+        if (!Varies(prefix.varying, t - 2)) {
+            w[t] += SIG1(w[t - 2]);
+        }
+        if (!Varies(prefix.varying, t - 7)) {
+            w[t] += w[t - 7];
+        }
+        if (!Varies(prefix.varying, t - 15)) {
+            w[t] += SIG0(w[t - 15]);
+        }
+        if (!Varies(prefix.varying, t - 16)) {
+            w[t] += w[t - 16];
+        }
+    }
+
+    memcpy(prefix.state, init, sizeof(prefix.state));
+    Rounds(prefix.state, w, 0, prefix.rounds);
+}
+
+void SHA256PrefixTransform(const SHA256Prefix& prefix, const uint32_t block[16], uint32_t out[8]) {
+    uint32_t w[64], v[8];
+
+    for (int t = 0; t < 16; ++t) {
+        w[t] = Varies(prefix.varying, t) ? block[t] : prefix.schedule[t];
+    }
+    for (int t = 16; t < 64; ++t) {
+        w[t] = prefix.schedule[t];
+        if (!Varies(prefix.varying, t)) {
+            continue;
+        }
+        if (Varies(prefix.varying, t - 2)) {
+            w[t] += SIG1(w[t - 2]);
+        }
+        if (Varies(prefix.varying, t - 7)) {
+            w[t] += w[t - 7];
+        }
+        if (Varies(prefix.varying, t - 15)) {
+            w[t] += SIG0(w[t - 15]);
+        }
+        if (Varies(prefix.varying, t - 16)) {
+            w[t] += w[t - 16];
+        }
+    }
+
+    memcpy(v, prefix.state, sizeof(v));
+    Rounds(v, w, prefix.rounds, 64);
+    for (int i = 0; i < 8; ++i) {
+        out[i] = prefix.init[i] + v[i];
+    }
+}
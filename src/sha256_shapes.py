@@ -0,0 +1,218 @@
+#!/usr/bin/env python3
+"""
+Fixed-length SHA256 message shapes shared by the PTX and C++ generators
+
+A shape is a message length. Padding fixes everything about its blocks
+except the message bytes, so each message word of each block is either
+data (possibly with padding bits below the last message byte) or a
+constant. From that one description:
+
+  - generate_sha256_ptx.py takes its padding words and the K + W
+    immediates of constant blocks, and
+  - running this script writes include/sha256_shapes.h, one C++ transform
+    per shape on the shared compression core (include/sha256_core.h),
+    instantiable on scalar words or SIMD lane vectors.
+
+So a specialised GPU kernel and its CPU counterpart cannot disagree on the
+padding or the precomputed schedule.
+"""
+
+import argparse
+from collections import namedtuple
+
+SHA256_K = [
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5,
+    0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+    0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc,
+    0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7,
+    0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+    0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3,
+    0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5,
+    0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+    0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+]
+
+# One message word: data says whether any message byte lands in it, bits
+# holds the padding bits (the whole word when data is false)
+Word = namedtuple("Word", "data bits")
+
+def rotr(x, n):
+    return ((x >> n) | (x << (32 - n))) & 0xffffffff
+
+def sigma0(x):
+    return rotr(x, 7) ^ rotr(x, 18) ^ (x >> 3)
+
+def sigma1(x):
+    return rotr(x, 17) ^ rotr(x, 19) ^ (x >> 10)
+
+class Shape:
+    """Blocks of a message_bytes-byte message, each 16 Words"""
+
+    def __init__(self, name, message_bytes, description):
+        self.name = name
+        self.message_bytes = message_bytes
+        self.description = description
+        padded = (message_bytes + 9 + 63) // 64 * 64
+        pad = [0] * (padded - message_bytes)
+        pad[0] = 0x80
+        pad[-8:] = list((message_bytes * 8).to_bytes(8, "big"))
+        self.blocks = []
+        for b in range(padded // 64):
+            block = []
+            for i in range(16):
+                offset = b * 64 + i * 4
+                bits = 0
+                for j in range(4):
+                    if offset + j >= message_bytes:
+                        bits |= pad[offset + j - message_bytes] << (24 - 8 * j)
+                block.append(Word(offset < message_bytes, bits))
+            self.blocks.append(block)
+
+    def data_words(self):
+        """Number of message words holding data, over all blocks"""
+        return sum(w.data for block in self.blocks for w in block)
+
+def known_schedule(block):
+    """W[0..63] of a block, with None for every word that depends on data"""
+    w = [None if word.data else word.bits for word in block]
+    for t in range(16, 64):
+        terms = [w[t - 2], w[t - 7], w[t - 15], w[t - 16]]
+        if None in terms:
+            w.append(None)
+        else:
+            w.append((sigma1(terms[0]) + terms[1] + sigma0(terms[2]) + terms[3]) & 0xffffffff)
+    return w
+
+def constant_kw(block):
+    """K[t] + W[t] for a block without data words"""
+    w = known_schedule(block)
+    assert None not in w, "block holds data words"
+    return [(k + x) & 0xffffffff for k, x in zip(SHA256_K, w)]
+
+# Shapes with specialised kernels
+SHAPES = {
+    "key33": Shape("key33", 33, "a compressed public key"),
+    "digest32": Shape("digest32", 32, "a digest (the second hash of SHA256d)"),
+    "node64": Shape("node64", 64, "a Merkle node (two child digests)"),
+    "header80": Shape("header80", 80, "a Bitcoin block header"),
+}
+
+def cpp_name(shape):
+    """C++ identifier stem, e.g. Key33 and KEY33"""
+    stem = shape.name.rstrip("0123456789")
+    digits = shape.name[len(stem):]
+    return stem.capitalize() + digits, shape.name.upper()
+
+def cpp_hex(value):
+    return f"0x{value:08x}u"
+
+def generate_cpp_shape(shape):
+    """Constant tables and transform template for one shape"""
+    camel, upper = cpp_name(shape)
+    code = f"""
+// {shape.message_bytes}-byte message, {shape.description}: {len(shape.blocks)} block{"s" if len(shape.blocks) > 1 else ""}, {shape.data_words()} data words
+#define SHA256_SHAPE_{upper}_BYTES {shape.message_bytes}
+#define SHA256_SHAPE_{upper}_DATA_WORDS {shape.data_words()}
+"""
+    for b, block in enumerate(shape.blocks):
+        count = sum(w.data for w in block)
+        if 0 < count < 16:
+            words = ",\n".join("    " + ", ".join(f"0x{w.bits:08x}" for w in block[i:i + 8]) for i in range(0, 16, 8))
+            varying = sum(1 << i for i, w in enumerate(block) if w.data)
+            code += f"""
+// Block {b} with its data words zero, and those words as a mask (bit i for
+// word i): a SHA256Prefix block for messages of this shape
+static const uint32_t SHA256_SHAPE_{upper}_BLOCK{b}[16] = {{
+{words}
+}};
+#define SHA256_SHAPE_{upper}_VARYING{b} 0x{varying:04x}u
+"""
+            continue
+        if count:
+            continue
+        kw = constant_kw(block)
+        rows = ",\n".join("    " + ", ".join(f"0x{x:08x}" for x in kw[i:i + 8]) for i in range(0, 64, 8))
+        code += f"""
+// K[i] + W[i] of block {b}: padding only
+static const uint32_t SHA256_SHAPE_{upper}_KW{b}[64] = {{
+{rows}
+}};
+"""
+    code += f"""
+template <typename T>
+static inline void SHA256Shape{camel}(T state[8], const T data[{shape.data_words()}]) {{
+"""
+    body = ""
+    need_window = False
+    offset = 0
+    for b, block in enumerate(shape.blocks):
+        count = sum(w.data for w in block)
+        if count == 0:
+            body += f"""    SHA256CoreTransformConstant(state, SHA256_SHAPE_{upper}_KW{b});
+"""
+            continue
+        if count == 16:
+            body += f"""    SHA256CoreTransform(state, data{f" + {offset}" if offset else ""});
+"""
+            offset += 16
+            continue
+        need_window = True
+        for i, word in enumerate(block):
+            if word.data and word.bits:
+                value = f"data[{offset + i}] | (T() + {cpp_hex(word.bits)})"
+            elif word.data:
+                value = f"data[{offset + i}]"
+            elif word.bits:
+                value = f"T() + {cpp_hex(word.bits)}"
+            else:
+                value = "T()"
+            body += f"""    w[{i}] = {value};
+"""
+        body += """    SHA256CoreTransform(state, w);
+"""
+        offset += count
+    if need_window:
+        code += """    T w[16];
+"""
+    return code + body + "}\n"
+
+def generate_cpp_header():
+    shapes = "".join(generate_cpp_shape(shape) for shape in SHAPES.values())
+    return f"""/*
+ * Fixed-length SHA256 shapes for HASH256_PTX
+ * Generated by src/sha256_shapes.py from the same shape table as the PTX
+ * kernels; do not edit.
+ *
+ * SHA256Shape<Name>(state, data) runs every compression of a message of
+ * the shape's length from state (normally SHA256_IV): data holds its
+ * message words, big-endian, bits past the last message byte zero, and
+ * padding words and padding-only blocks are compile-time constants. T is
+ * uint32_t or a lane vector of the shared core.
+ *
+ * A block mixing data and padding is also given as SHA256_SHAPE_<NAME>_BLOCK<b>
+ * with SHA256_SHAPE_<NAME>_VARYING<b>, ready for SHA256PrefixInit.
+ */
+
+#ifndef SHA256_SHAPES_H
+#define SHA256_SHAPES_H
+
+#include "sha256_core.h"
+{shapes}
+#endif // SHA256_SHAPES_H
+"""
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description="Generate the fixed-length SHA256 shape header")
+    parser.add_argument("-o", "--output", default="include/sha256_shapes.h", help="output header path")
+    args = parser.parse_args()
+
+    with open(args.output, "w") as f:
+        f.write(generate_cpp_header())
+    print(f"✓ Generated {args.output}")
@@ -0,0 +1,194 @@
+/*
+ * SHA512 and SHA-512/256 for HASH256_PTX
+ */
+
+#include "sha512.h"
+#include "sha512_ops.h"
+
+const uint64_t SHA512_K[80] = {
+    0x428a2f98d728ae22ULL, 0x7137449123ef65cdULL, 0xb5c0fbcfec4d3b2fULL, 0xe9b5dba58189dbbcULL,
+    0x3956c25bf348b538ULL, 0x59f111f1b605d019ULL, 0x923f82a4af194f9bULL, 0xab1c5ed5da6d8118ULL,
+    0xd807aa98a3030242ULL, 0x12835b0145706fbeULL, 0x243185be4ee4b28cULL, 0x550c7dc3d5ffb4e2ULL,
+    0x72be5d74f27b896fULL, 0x80deb1fe3b1696b1ULL, 0x9bdc06a725c71235ULL, 0xc19bf174cf692694ULL,
+    0xe49b69c19ef14ad2ULL, 0xefbe4786384f25e3ULL, 0x0fc19dc68b8cd5b5ULL, 0x240ca1cc77ac9c65ULL,
+    0x2de92c6f592b0275ULL, 0x4a7484aa6ea6e483ULL, 0x5cb0a9dcbd41fbd4ULL, 0x76f988da831153b5ULL,
+    0x983e5152ee66dfabULL, 0xa831c66d2db43210ULL, 0xb00327c898fb213fULL, 0xbf597fc7beef0ee4ULL,
+    0xc6e00bf33da88fc2ULL, 0xd5a79147930aa725ULL, 0x06ca6351e003826fULL, 0x142929670a0e6e70ULL,
+    0x27b70a8546d22ffcULL, 0x2e1b21385c26c926ULL, 0x4d2c6dfc5ac42aedULL, 0x53380d139d95b3dfULL,
+    0x650a73548baf63deULL, 0x766a0abb3c77b2a8ULL, 0x81c2c92e47edaee6ULL, 0x92722c851482353bULL,
+    0xa2bfe8a14cf10364ULL, 0xa81a664bbc423001ULL, 0xc24b8b70d0f89791ULL, 0xc76c51a30654be30ULL,
+    0xd192e819d6ef5218ULL, 0xd69906245565a910ULL, 0xf40e35855771202aULL, 0x106aa07032bbd1b8ULL,
+    0x19a4c116b8d2d0c8ULL, 0x1e376c085141ab53ULL, 0x2748774cdf8eeb99ULL, 0x34b0bcb5e19b48a8ULL,
+    0x391c0cb3c5c95a63ULL, 0x4ed8aa4ae3418acbULL, 0x5b9cca4f7763e373ULL, 0x682e6ff3d6b2b8a3ULL,
+    0x748f82ee5defb2fcULL, 0x78a5636f43172f60ULL, 0x84c87814a1f0ab72ULL, 0x8cc702081a6439ecULL,
+    0x90befffa23631e28ULL, 0xa4506cebde82bde9ULL, 0xbef9a3f7b2c67915ULL, 0xc67178f2e372532bULL,
+    0xca273eceea26619cULL, 0xd186b8c721c0c207ULL, 0xeada7dd6cde0eb1eULL, 0xf57d4f7fee6ed178ULL,
+    0x06f067aa72176fbaULL, 0x0a637dc5a2c898a6ULL, 0x113f9804bef90daeULL, 0x1b710b35131c471bULL,
+    0x28db77f523047d84ULL, 0x32caab7b40c72493ULL, 0x3c9ebe0a15c9bebcULL, 0x431d67c49c100d4cULL,
+    0x4cc5d4becb3e42b6ULL, 0x597f299cfc657e2aULL, 0x5fcb6fab3ad6faecULL, 0x6c44198c4a475817ULL
+};
+
+const uint64_t SHA512_IV[8] = {
+    0x6a09e667f3bcc908ULL, 0xbb67ae8584caa73bULL, 0x3c6ef372fe94f82bULL, 0xa54ff53a5f1d36f1ULL,
+    0x510e527fade682d1ULL, 0x9b05688c2b3e6c1fULL, 0x1f83d9abfb41bd6bULL, 0x5be0cd19137e2179ULL
+};
+
+// FIPS 180-4 5.3.6.2: the SHA-512/t IV generation function applied to "SHA-512/256"
+const uint64_t SHA512_256_IV[8] = {
+    0x22312194fc2bf72cULL, 0x9f555fa3c84c64c2ULL, 0x2393b86b6f53b151ULL, 0x963877195940eabdULL,
+    0x96283ee2a88effe3ULL, 0xbe5e1e2553863992ULL, 0x2b0199fc2c85b8aaULL, 0x0eb72ddc81c52ca2ULL
+};
+
+SHA512::SHA512() {
+    Init();
+}
+
+void SHA512::Init() {
+    Init(SHA512_IV);
+}
+
+void SHA512::Init(const uint64_t iv[8]) {
+    for (int i = 0; i < 8; ++i) {
+        state[i] = iv[i];
+    }
+    count = 0;
+}
+
+void SHA512::Transform(const uint8_t* data) {
+    uint64_t a, b, c, d, e, f, g, h, t1, t2, m[80];
+
+    for (int i = 0; i < 16; ++i) {
+        m[i] = ReadBE64(data + i * 8);
+    }
+    for (int i = 16; i < 80; ++i) {
+        m[i] = SIG1_64(m[i - 2]) + m[i - 7] + SIG0_64(m[i - 15]) + m[i - 16];
+    }
+
+    a = state[0];
+    b = state[1];
+    c = state[2];
+    d = state[3];
+    e = state[4];
+    f = state[5];
+    g = state[6];
+    h = state[7];
+
+    for (int i = 0; i < 80; ++i) {
+        t1 = h + EP1_64(e) + CH64(e, f, g) + SHA512_K[i] + m[i];
+        t2 = EP0_64(a) + MAJ64(a, b, c);
+        h = g;
+        g = f;
+        f = e;
+        e = d + t1;
+        d = c;
+        c = b;
+        b = a;
+        a = t1 + t2;
+    }
+
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+    state[4] += e;
+    state[5] += f;
+    state[6] += g;
+    state[7] += h;
+}
+
+void SHA512::Update(const uint8_t* data, size_t len) {
+    size_t i = 0;
+    size_t bufferSpace = 128 - (count % 128);
+
+    count += len;
+
+    if (len >= bufferSpace) {
+        memcpy(buffer + (128 - bufferSpace), data, bufferSpace);
+        Transform(buffer);
+
+        for (i = bufferSpace; i + 128 <= len; i += 128) {
+            Transform(data + i);
+        }
+
+        bufferSpace = 128;
+    }
+
+    memcpy(buffer + (128 - bufferSpace), data + i, len - i);
+}
+
+void SHA512::Pad() {
+    size_t i = count % 128;
+
+    buffer[i++] = 0x80;
+
+    if (i > 112) {
+        memset(buffer + i, 0, 128 - i);
+        Transform(buffer);
+        i = 0;
+    }
+
+    // 128-bit big-endian bit length; byte counts fit in 64 bits, so the
+    // high half only holds the three bits shifted out by * 8
+    memset(buffer + i, 0, 112 - i);
+    WriteBE64(buffer + 112, count >> 61);
+    WriteBE64(buffer + 120, count << 3);
+
+    Transform(buffer);
+}
+
+void SHA512::Final(uint8_t hash[64]) {
+    Pad();
+    for (int i = 0; i < 8; ++i) {
+        WriteBE64(hash + i * 8, state[i]);
+    }
+}
+
+void SHA512::FinalWords(uint64_t hash[8]) {
+    Pad();
+    for (int i = 0; i < 8; ++i) {
+        hash[i] = state[i];
+    }
+}
+
+void SHA512::Midstate(uint64_t out[8]) const {
+    for (int i = 0; i < 8; ++i) {
+        out[i] = state[i];
+    }
+}
+
+void SHA512::SetMidstate(const uint64_t in[8], uint64_t len) {
+    for (int i = 0; i < 8; ++i) {
+        state[i] = in[i];
+    }
+    count = len;
+}
+
+void SHA512::Hash(const uint8_t* data, size_t len, uint8_t hash[64]) {
+    SHA512 sha;
+    sha.Update(data, len);
+    sha.Final(hash);
+}
+
+SHA512_256::SHA512_256() {
+    Init();
+}
+
+void SHA512_256::Init() {
+    sha.Init(SHA512_256_IV);
+}
+
+void SHA512_256::Update(const uint8_t* data, size_t len) {
+    sha.Update(data, len);
+}
+
+void SHA512_256::Final(uint8_t hash[32]) {
+    uint8_t full[64];
+    sha.Final(full);
+    memcpy(hash, full, 32);
+}
+
+void SHA512_256::Hash(const uint8_t* data, size_t len, uint8_t hash[32]) {
+    SHA512_256 sha;
+    sha.Update(data, len);
+    sha.Final(hash);
+}
@@ -0,0 +1,106 @@
+/*
+ * Lane-parallel SHA512 for HASH256_PTX
+ * Every statement is a loop over SHA512_LANES so -O3 vectorises it
+ */
+
+#include "sha512_lanes.h"
+#include "sha512_ops.h"
+
+#define LANES SHA512_LANES
+
+// One round on all lanes. Roles rotate through the macro arguments instead of
+// moving the working variables: the new a is written to h and the new e to d.
+#define ROUND_LANES64(a, b, c, d, e, f, g, h, i)                                              \
+    for (int l = 0; l < LANES; ++l) {                                                         \
+        uint64_t t1 = h[l] + EP1_64(e[l]) + CH64(e[l], f[l], g[l]) + SHA512_K[i] + w[i][l]; \
+        uint64_t t2 = EP0_64(a[l]) + MAJ64(a[l], b[l], c[l]);                                 \
+        d[l] += t1;                                                                           \
+        h[l] = t1 + t2;                                                                       \
+    }
+
+void SHA512TransformLanes(uint64_t state[8][SHA512_LANES], const uint64_t block[16][SHA512_LANES]) {
+    uint64_t w[80][LANES];
+    uint64_t a[LANES], b[LANES], c[LANES], d[LANES], e[LANES], f[LANES], g[LANES], h[LANES];
+
+    memcpy(w, block, sizeof(uint64_t) * 16 * LANES);
+    for (int i = 16; i < 80; ++i) {
+        for (int l = 0; l < LANES; ++l) {
+            w[i][l] = SIG1_64(w[i - 2][l]) + w[i - 7][l] + SIG0_64(w[i - 15][l]) + w[i - 16][l];
+        }
+    }
+
+    memcpy(a, state[0], sizeof(a));
+    memcpy(b, state[1], sizeof(b));
+    memcpy(c, state[2], sizeof(c));
+    memcpy(d, state[3], sizeof(d));
+    memcpy(e, state[4], sizeof(e));
+    memcpy(f, state[5], sizeof(f));
+    memcpy(g, state[6], sizeof(g));
+    memcpy(h, state[7], sizeof(h));
+
+    for (int i = 0; i < 80; i += 8) {
+        ROUND_LANES64(a, b, c, d, e, f, g, h, i);
+        ROUND_LANES64(h, a, b, c, d, e, f, g, i + 1);
+        ROUND_LANES64(g, h, a, b, c, d, e, f, i + 2);
+        ROUND_LANES64(f, g, h, a, b, c, d, e, i + 3);
+        ROUND_LANES64(e, f, g, h, a, b, c, d, i + 4);
+        ROUND_LANES64(d, e, f, g, h, a, b, c, i + 5);
+        ROUND_LANES64(c, d, e, f, g, h, a, b, i + 6);
+        ROUND_LANES64(b, c, d, e, f, g, h, a, i + 7);
+    }
+
+    for (int l = 0; l < LANES; ++l) {
+        state[0][l] += a[l];
+        state[1][l] += b[l];
+        state[2][l] += c[l];
+        state[3][l] += d[l];
+        state[4][l] += e[l];
+        state[5][l] += f[l];
+        state[6][l] += g[l];
+        state[7][l] += h[l];
+    }
+}
+
+void SHA512HashLanes(const uint64_t init[8], uint64_t prefix_len,
+                     const uint8_t* const data[SHA512_LANES], size_t len,
+                     uint64_t out[8][SHA512_LANES]) {
+    uint64_t block[16][LANES];
+
+    for (int i = 0; i < 8; ++i) {
+        for (int l = 0; l < LANES; ++l) {
+            out[i][l] = init[i];
+        }
+    }
+
+    // Full blocks straight from the inputs
+    size_t offset = 0;
+    for (; offset + 128 <= len; offset += 128) {
+        for (int l = 0; l < LANES; ++l) {
+            for (int i = 0; i < 16; ++i) {
+                block[i][l] = ReadBE64(data[l] + offset + i * 8);
+            }
+        }
+        SHA512TransformLanes(out, block);
+    }
+
+    // Tail plus padding: one block, or two when the length does not fit
+    size_t tail = len - offset;
+    size_t tail_blocks = tail < 112 ? 1 : 2;
+    uint64_t byte_count = prefix_len + len;
+    uint8_t padded[LANES][256];
+    for (int l = 0; l < LANES; ++l) {
+        memcpy(padded[l], data[l] + offset, tail);
+        padded[l][tail] = 0x80;
+        memset(padded[l] + tail + 1, 0, tail_blocks * 128 - tail - 1);
+        WriteBE64(padded[l] + tail_blocks * 128 - 16, byte_count >> 61);
+        WriteBE64(padded[l] + tail_blocks * 128 - 8, byte_count << 3);
+    }
+    for (size_t blk = 0; blk < tail_blocks; ++blk) {
+        for (int l = 0; l < LANES; ++l) {
+            for (int i = 0; i < 16; ++i) {
+                block[i][l] = ReadBE64(padded[l] + blk * 128 + i * 8);
+            }
+        }
+        SHA512TransformLanes(out, block);
+    }
+}
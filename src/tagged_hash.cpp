@@ -0,0 +1,68 @@
+/*
+ * BIP340 tagged hashes for HASH256_PTX
+ */
+
+#include "tagged_hash.h"
+#include "sha256.h"
+#include "sha256_lanes.h"
+#include "sha256_ops.h"
+#include <map>
+#include <mutex>
+#include <string>
+
+void TaggedHashTagInit(TaggedHashTag& tag, const uint8_t* name, size_t len) {
+    uint8_t digest[32];
+    SHA256::Hash(name, len, digest);
+
+    SHA256 sha;
+    sha.Update(digest, 32);
+    sha.Update(digest, 32);
+    sha.Midstate(tag.midstate);
+}
+
+const TaggedHashTag& TaggedHashTagFor(const char* name) {
+    // std::map never moves its elements, so handed-out references stay valid
+    static std::map<std::string, TaggedHashTag> cache;
+    static std::mutex lock;
+
+    std::lock_guard<std::mutex> guard(lock);
+    std::map<std::string, TaggedHashTag>::iterator it = cache.find(name);
+    if (it == cache.end()) {
+        it = cache.insert(std::make_pair(std::string(name), TaggedHashTag())).first;
+        TaggedHashTagInit(it->second, (const uint8_t*)name, strlen(name));
+    }
+    return it->second;
+}
+
+void TaggedHash(const TaggedHashTag& tag, const uint8_t* msg, size_t len, uint8_t hash[32]) {
+    SHA256 sha;
+    sha.SetMidstate(tag.midstate, 64);
+    sha.Update(msg, len);
+    sha.Final(hash);
+}
+
+void TaggedHash(const char* tag, const uint8_t* msg, size_t len, uint8_t hash[32]) {
+    TaggedHash(TaggedHashTagFor(tag), msg, len, hash);
+}
+
+void TaggedHashBatch(const TaggedHashTag& tag, const uint8_t* msgs, size_t len, uint8_t* hashes, size_t count) {
+    const uint8_t* lane_data[SHA256_LANES];
+    uint32_t state[8][SHA256_LANES];
+
+    for (size_t base = 0; base < count; base += SHA256_LANES) {
+        // A short final group repeats its last message in the spare lanes
+        size_t active = count - base < SHA256_LANES ? count - base : SHA256_LANES;
+        for (size_t l = 0; l < SHA256_LANES; ++l) {
+            size_t n = l < active ? l : active - 1;
+            lane_data[l] = msgs + (base + n) * len;
+        }
+
+        SHA256HashLanes(tag.midstate, 64, lane_data, len, state);
+
+        for (size_t l = 0; l < active; ++l) {
+            for (int i = 0; i < 8; ++i) {
+                WriteBE32(hashes + (base + l) * 32 + i * 4, state[i][l]);
+            }
+        }
+    }
+}
@@ -0,0 +1,75 @@
+/*
+ * Target filter for HASH256_PTX
+ */
+
+#include "target_filter.h"
+
+// Keep in sync with FILTER_SALT in generate_sha256_ptx.py
+static const uint32_t TARGET_FILTER_SALT[TARGET_FILTER_BLOCK_WORDS] = {
+    0x47b6137b, 0x44974d91, 0x8824ad5b, 0xa2b7289d,
+    0x705495c7, 0x2df1424b, 0x9efc4947, 0x5c6bfb31
+};
+
+TargetFilter::TargetFilter() {
+    Init(0);
+}
+
+// Block and bit words of a digest for the filter's key
+static inline uint32_t BlockWord(TargetFilterKey key, const uint32_t digest[8]) {
+    return key == TARGET_FILTER_KEY_H7H3 ? digest[7] : digest[0];
+}
+
+static inline uint32_t BitWord(TargetFilterKey key, const uint32_t digest[8]) {
+    return key == TARGET_FILTER_KEY_H7H3 ? digest[3] : digest[1];
+}
+
+void TargetFilter::Init(size_t expected_targets, size_t bits_per_target, TargetFilterKey filter_key) {
+    key = filter_key;
+    size_t bits = expected_targets * bits_per_target;
+    size_t num_blocks = 1;
+    while (num_blocks * 256 < bits) {
+        num_blocks <<= 1;
+    }
+    blocks.assign(num_blocks * TARGET_FILTER_BLOCK_WORDS, 0);
+}
+
+void TargetFilter::Insert(const uint32_t digest[8]) {
+    uint32_t bit_word = BitWord(key, digest);
+    uint32_t* block = &blocks[(size_t)(BlockWord(key, digest) & BlockMask()) * TARGET_FILTER_BLOCK_WORDS];
+    for (int i = 0; i < TARGET_FILTER_BLOCK_WORDS; ++i) {
+        block[i] |= 1u << ((bit_word * TARGET_FILTER_SALT[i]) >> 27);
+    }
+}
+
+void TargetFilter::InsertBatch(const uint32_t* digests, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        Insert(digests + i * 8);
+    }
+}
+
+bool TargetFilter::MayContain(const uint32_t digest[8]) const {
+    return MayContainKey(BlockWord(key, digest), BitWord(key, digest));
+}
+
+bool TargetFilter::MayContainKey(uint32_t block_word, uint32_t bit_word) const {
+    const uint32_t* block = &blocks[(size_t)(block_word & BlockMask()) * TARGET_FILTER_BLOCK_WORDS];
+    uint32_t bits = 1;
+    for (int i = 0; i < TARGET_FILTER_BLOCK_WORDS; ++i) {
+        bits &= block[i] >> ((bit_word * TARGET_FILTER_SALT[i]) >> 27);
+    }
+    return bits != 0;
+}
+
+size_t TargetFilterMatch(const TargetFilter& filter, const uint32_t* digests, size_t count,
+                         uint32_t* hits, size_t max_hits) {
+    size_t num_hits = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (filter.MayContain(digests + i * 8)) {
+            if (num_hits < max_hits) {
+                hits[num_hits] = (uint32_t)i;
+            }
+            num_hits++;
+        }
+    }
+    return num_hits;
+}
@@ -7,7 +7,12 @@
 #include <string.h>
 #include <stdint.h>
 #include <chrono>
+#include <algorithm>
 #include "sha256.h"
+#include "sha256_digest.h"
+#include "sha256_match.h"
+#include "sha256_node.h"
+#include "sha256_arena.h"
 #include "ptx_sha256.hpp"
 
 void print_hex(const char* label, const uint8_t* data, size_t len) {
@@ -119,6 +124,295 @@ int main() {
         return 1;
     }
     
+    // Test word-layout kernel
+    printf("Testing word-layout kernel...\n");
+    {
+        PTX_SHA256 ptx_words;
+        if (!ptx_words.initialize("ptx/sha256_kernel_words.ptx")) {
+            printf("❌ Failed to initialize word-layout kernel\n");
+            delete[] input_batch;
+            delete[] cpu_batch;
+            delete[] gpu_batch;
+            return 1;
+        }
+        
+        uint32_t* gpu_words = new uint32_t[batch_size * 8];
+        bool ok = ptx_words.hash_batch_words(input_batch, gpu_words, batch_size);
+        if (ok) {
+            DigestWordsToBytes(gpu_words, gpu_batch, batch_size);
+            ok = compare_hashes(cpu_batch, gpu_batch, batch_size * 32);
+        }
+        delete[] gpu_words;
+        
+        if (ok) {
+            printf("✓ All %d word-layout hashes match!\n\n", batch_size);
+        } else {
+            printf("❌ Word-layout hashes do NOT match!\n\n");
+            delete[] input_batch;
+            delete[] cpu_batch;
+            delete[] gpu_batch;
+            return 1;
+        }
+    }
+    
+    // Test on-device key enumeration
+    printf("Testing counter-mode kernel...\n");
+    {
+        PTX_SHA256 ptx_counter;
+        if (!ptx_counter.initialize("ptx/sha256_kernel_counter.ptx")) {
+            printf("❌ Failed to initialize counter-mode kernel\n");
+            delete[] input_batch;
+            delete[] cpu_batch;
+            delete[] gpu_batch;
+            return 1;
+        }
+        
+        // Start just below a carry into the second counter byte
+        const uint64_t start = 200;
+        KeyCounterHashBatch(test_pubkey, KEY_COUNTER_DEFAULT_LAYOUT, start, cpu_batch, batch_size);
+        bool ok = ptx_counter.hash_counter_batch(test_pubkey, KEY_COUNTER_DEFAULT_LAYOUT, start,
+                                                 gpu_batch, batch_size) &&
+                  compare_hashes(cpu_batch, gpu_batch, batch_size * 32);
+        
+        if (ok) {
+            printf("✓ All %d counter-mode hashes match!\n\n", batch_size);
+        } else {
+            printf("❌ Counter-mode hashes do NOT match!\n\n");
+            delete[] input_batch;
+            delete[] cpu_batch;
+            delete[] gpu_batch;
+            return 1;
+        }
+    }
+    
+    // Test precomputed fixed-prefix rounds on the same keys
+    printf("Testing prefix kernel...\n");
+    {
+        PTX_SHA256 ptx_prefix;
+        if (!ptx_prefix.initialize("ptx/sha256_kernel_prefix.ptx")) {
+            printf("❌ Failed to initialize prefix kernel\n");
+            delete[] input_batch;
+            delete[] cpu_batch;
+            delete[] gpu_batch;
+            return 1;
+        }
+        
+        // cpu_batch still holds the counter-mode reference for start 200
+        SHA256Prefix prefix;
+        KeyCounterPrefixInit(test_pubkey, KEY_COUNTER_DEFAULT_LAYOUT, prefix);
+        bool ok = ptx_prefix.hash_prefix_batch(prefix, KEY_COUNTER_DEFAULT_LAYOUT, 200, gpu_batch, batch_size) &&
+                  compare_hashes(cpu_batch, gpu_batch, batch_size * 32);
+        
+        if (ok) {
+            printf("✓ All %d prefix hashes match (%u rounds precomputed)!\n\n", batch_size, prefix.rounds);
+        } else {
+            printf("❌ Prefix hashes do NOT match!\n\n");
+            delete[] input_batch;
+            delete[] cpu_batch;
+            delete[] gpu_batch;
+            return 1;
+        }
+    }
+    
+    // Test 64-byte Merkle node hashing: pairs of the digests above as children
+    printf("Testing node64 kernel...\n");
+    {
+        PTX_SHA256 ptx_node;
+        if (!ptx_node.initialize("ptx/sha256_kernel_node64_words.ptx")) {
+            printf("❌ Failed to initialize node64 kernel\n");
+            delete[] input_batch;
+            delete[] cpu_batch;
+            delete[] gpu_batch;
+            return 1;
+        }
+        
+        const uint32_t num_nodes = batch_size / 2;
+        uint32_t* children = new uint32_t[num_nodes * 16];
+        uint32_t* cpu_parents = new uint32_t[num_nodes * 8];
+        uint32_t* gpu_parents = new uint32_t[num_nodes * 8];
+        DigestBytesToWords(cpu_batch, children, num_nodes * 2);
+        SHA256Node64Batch(children, cpu_parents, num_nodes);
+        bool ok = ptx_node.hash_node64_batch_words(children, gpu_parents, num_nodes) &&
+                  memcmp(cpu_parents, gpu_parents, num_nodes * 32) == 0;
+        delete[] children;
+        delete[] cpu_parents;
+        delete[] gpu_parents;
+        
+        if (ok) {
+            printf("✓ All %u node64 hashes match!\n\n", num_nodes);
+        } else {
+            printf("❌ Node64 hashes do NOT match!\n\n");
+            delete[] input_batch;
+            delete[] cpu_batch;
+            delete[] gpu_batch;
+            return 1;
+        }
+    }
+    
+    // Test variable-length messages from a packed arena, lengths 0..299 so
+    // every padding boundary and one to five blocks are covered
+    printf("Testing arena kernel...\n");
+    {
+        PTX_SHA256 ptx_arena;
+        if (!ptx_arena.initialize("ptx/sha256_kernel_arena.ptx")) {
+            printf("❌ Failed to initialize arena kernel\n");
+            delete[] input_batch;
+            delete[] cpu_batch;
+            delete[] gpu_batch;
+            return 1;
+        }
+        
+        const size_t num_msgs = 300;
+        std::vector<uint8_t> data(num_msgs * num_msgs);
+        std::vector<const uint8_t*> msgs(num_msgs);
+        std::vector<size_t> lens(num_msgs);
+        for (size_t i = 0; i < data.size(); i++) {
+            data[i] = (uint8_t)(i * 131 + 7);
+        }
+        for (size_t i = 0; i < num_msgs; i++) {
+            // Shuffled lengths, so the packer has to bucket them
+            lens[i] = (i * 7) % num_msgs;
+            msgs[i] = &data[i * num_msgs];
+        }
+        SHA256Arena arena;
+        std::vector<uint8_t> cpu_hashes(num_msgs * 32), gpu_hashes(num_msgs * 32);
+        bool ok = SHA256ArenaPack(arena, &msgs[0], &lens[0], num_msgs) &&
+                  ptx_arena.hash_arena_batch(arena, &gpu_hashes[0]);
+        for (size_t i = 0; ok && i < num_msgs; i++) {
+            SHA256::Hash(msgs[i], lens[i], &cpu_hashes[i * 32]);
+        }
+        ok = ok && cpu_hashes == gpu_hashes;
+        
+        if (ok) {
+            printf("✓ All %zu arena hashes match!\n\n", num_msgs);
+        } else {
+            printf("❌ Arena hashes do NOT match!\n\n");
+            delete[] input_batch;
+            delete[] cpu_batch;
+            delete[] gpu_batch;
+            return 1;
+        }
+    }
+    
+    // Test device-side target filtering
+    printf("Testing filter kernel...\n");
+    {
+        // Every tenth key is a target; the CPU matcher gives the expected hit list
+        uint32_t* cpu_words = new uint32_t[batch_size * 8];
+        for (int i = 0; i < batch_size; i++) {
+            SHA256::Hash(input_batch + i * 33, 33, cpu_batch + i * 32);
+        }
+        DigestBytesToWords(cpu_batch, cpu_words, batch_size);
+        TargetFilter filter;
+        filter.Init(batch_size / 10);
+        for (int i = 0; i < batch_size; i += 10) {
+            filter.Insert(cpu_words + i * 8);
+        }
+        uint32_t* expected_hits = new uint32_t[batch_size];
+        uint32_t* gpu_hits = new uint32_t[batch_size];
+        size_t expected_count = TargetFilterMatch(filter, cpu_words, batch_size, expected_hits, batch_size);
+        
+        PTX_SHA256 ptx_filter;
+        uint32_t num_hits = 0;
+        bool ok = ptx_filter.initialize("ptx/sha256_kernel_filter.ptx") &&
+                  ptx_filter.load_filter(filter) &&
+                  ptx_filter.hash_batch_filter(input_batch, gpu_hits, batch_size, batch_size, &num_hits) &&
+                  num_hits == expected_count;
+        if (ok) {
+            // Hits arrive in arbitrary order
+            std::sort(gpu_hits, gpu_hits + num_hits);
+            ok = memcmp(gpu_hits, expected_hits, num_hits * sizeof(uint32_t)) == 0;
+        }
+        // A short hit list still reports the full count
+        uint32_t few_hits[4];
+        ok = ok && ptx_filter.hash_batch_filter(input_batch, few_hits, 4, batch_size, &num_hits) &&
+             num_hits == expected_count;
+        
+        delete[] cpu_words;
+        delete[] expected_hits;
+        delete[] gpu_hits;
+        
+        if (ok) {
+            printf("✓ Filter kernel reports all %zu candidate keys!\n\n", expected_count);
+        } else {
+            printf("❌ Filter kernel hit list does NOT match!\n\n");
+            delete[] input_batch;
+            delete[] cpu_batch;
+            delete[] gpu_batch;
+            return 1;
+        }
+    }
+    
+    // Test match mode (early reject after round 60)
+    printf("Testing match kernel...\n");
+    {
+        uint32_t* cpu_words = new uint32_t[batch_size * 8];
+        DigestBytesToWords(cpu_batch, cpu_words, batch_size);
+        TargetFilter filter;
+        filter.Init(batch_size / 10, 16, TARGET_FILTER_KEY_H7H3);
+        for (int i = 0; i < batch_size; i += 10) {
+            filter.Insert(cpu_words + i * 8);
+        }
+        TargetHit* expected_hits = new TargetHit[batch_size];
+        TargetHit* gpu_hits = new TargetHit[batch_size];
+        size_t expected_count = SHA256MatchBatch(filter, input_batch, 33, batch_size, expected_hits, batch_size);
+        
+        PTX_SHA256 ptx_match;
+        uint32_t num_hits = 0;
+        bool ok = ptx_match.initialize("ptx/sha256_kernel_match.ptx") &&
+                  ptx_match.load_filter(filter) &&
+                  ptx_match.hash_batch_match(input_batch, gpu_hits, batch_size, batch_size, &num_hits) &&
+                  num_hits == expected_count;
+        if (ok) {
+            std::sort(gpu_hits, gpu_hits + num_hits,
+                      [](const TargetHit& a, const TargetHit& b) { return a.index < b.index; });
+            ok = memcmp(gpu_hits, expected_hits, num_hits * sizeof(TargetHit)) == 0;
+        }
+        
+        delete[] cpu_words;
+        delete[] expected_hits;
+        delete[] gpu_hits;
+        
+        if (ok) {
+            printf("✓ Match kernel returns all %zu candidates with digests!\n\n", expected_count);
+        } else {
+            printf("❌ Match kernel hit records do NOT match!\n\n");
+            delete[] input_batch;
+            delete[] cpu_batch;
+            delete[] gpu_batch;
+            return 1;
+        }
+    }
+    
+    // Test interleaved (ILP) grid-stride kernels
+    {
+        const char* ilp_kernels[] = {"ptx/sha256_kernel_ilp2.ptx", "ptx/sha256_kernel_ilp4.ptx"};
+        for (const char* path : ilp_kernels) {
+            printf("Testing %s...\n", path);
+            PTX_SHA256 ptx_ilp;
+            bool ok = ptx_ilp.initialize(path);
+            if (ok) {
+                printf("  ILP %u, %d registers per thread\n", ptx_ilp.ilp(), ptx_ilp.num_registers());
+                // cpu_batch was reused by the counter test; recompute the reference
+                for (int i = 0; i < batch_size; i++) {
+                    SHA256::Hash(input_batch + i * 33, 33, cpu_batch + i * 32);
+                }
+                // Odd size: the last pass has hashes with nothing to store
+                ok = ptx_ilp.hash_batch(input_batch, gpu_batch, batch_size - 3) &&
+                     compare_hashes(cpu_batch, gpu_batch, (batch_size - 3) * 32);
+            }
+            if (ok) {
+                printf("✓ All %d ILP hashes match!\n\n", batch_size - 3);
+            } else {
+                printf("❌ ILP hashes do NOT match!\n\n");
+                delete[] input_batch;
+                delete[] cpu_batch;
+                delete[] gpu_batch;
+                return 1;
+            }
+        }
+    }
+    
     delete[] input_batch;
     delete[] cpu_batch;
     delete[] gpu_batch;
@@ -168,6 +462,25 @@ int main() {
     printf("Performance: %.5f GHashes/s\n", mhashes_per_sec / 1000.0);
     printf("\n");
     
+    // Same batch on each interleaving variant (includes PCIe transfers)
+    printf("Kernel variants:\n");
+    const char* variants[] = {"ptx/sha256_kernel_full.ptx", "ptx/sha256_kernel_ilp2.ptx",
+                              "ptx/sha256_kernel_ilp4.ptx"};
+    for (const char* path : variants) {
+        PTX_SHA256 variant;
+        if (!variant.initialize(path)) {
+            printf("  %-30s failed to load\n", path);
+            continue;
+        }
+        variant.hash_batch(bench_input, bench_output, benchmark_batch);
+        auto t0 = std::chrono::high_resolution_clock::now();
+        variant.hash_batch(bench_input, bench_output, benchmark_batch);
+        double t = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - t0).count();
+        printf("  %-30s ILP %u  %3d registers  %8.2f MHashes/s\n",
+               path, variant.ilp(), variant.num_registers(), benchmark_batch / t / 1000000.0);
+    }
+    printf("\n");
+    
     delete[] bench_input;
     delete[] bench_output;
     
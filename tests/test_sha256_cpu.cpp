@@ -0,0 +1,1494 @@
+/*
+ * CPU-side tests for HASH256_PTX
+ * Runs without a GPU: checks the SHA256 reference and host utilities
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include "sha256.h"
+#include "sha256_digest.h"
+#include "sha256_lanes.h"
+#include "sha256_ops.h"
+#include "ripemd160.h"
+#include "hash160.h"
+#include "key_counter.h"
+#include "target_filter.h"
+#include "sha256_match.h"
+#include "sha256_prefix.h"
+#include "header_sweep.h"
+#include "sha256_node.h"
+#include "merkle.h"
+#include "tagged_hash.h"
+#include "hmac_sha256.h"
+#include "pbkdf2.h"
+#include "hkdf.h"
+#include "sha512.h"
+#include "sha512_lanes.h"
+#include "sha512_ops.h"
+#include "hmac_sha512.h"
+#include "sha256_constexpr.h"
+#include "sha256_shapes.h"
+#include "sha256_arena.h"
+#include "sha256_batch.h"
+
+static int failures = 0;
+
+static void check(bool ok, const char* what) {
+    if (ok) {
+        printf("✓ %s\n", what);
+    } else {
+        printf("❌ %s\n", what);
+        failures++;
+    }
+}
+
+static void print_hex(const char* label, const uint8_t* data, size_t len) {
+    printf("%s: ", label);
+    for (size_t i = 0; i < len; i++) {
+        printf("%02x", data[i]);
+    }
+    printf("\n");
+}
+
+static void parse_hex(const char* hex, uint8_t* out) {
+    for (size_t i = 0; hex[2 * i]; i++) {
+        unsigned int byte;
+        sscanf(hex + 2 * i, "%2x", &byte);
+        out[i] = (uint8_t)byte;
+    }
+}
+
+static bool hash_matches(const uint8_t* data, size_t len, const char* expected_hex) {
+    uint8_t expected[32], hash[32];
+    parse_hex(expected_hex, expected);
+    SHA256::Hash(data, len, hash);
+    if (memcmp(hash, expected, 32) != 0) {
+        print_hex("  got     ", hash, 32);
+        printf("  expected: %s\n", expected_hex);
+        return false;
+    }
+    return true;
+}
+
+// Deterministic test data
+static void fill_pattern(uint8_t* data, size_t len, uint32_t seed) {
+    for (size_t i = 0; i < len; i++) {
+        seed = seed * 1103515245 + 12345;
+        data[i] = (uint8_t)(seed >> 16);
+    }
+}
+
+// Test vector: compressed public key for private key 0x1
+static constexpr uint8_t test_pubkey[33] = {
+    0x02, 0x79, 0xBE, 0x66, 0x7E, 0xF9, 0xDC, 0xBB, 0xAC, 0x55, 0xA0, 0x62,
+    0x95, 0xCE, 0x87, 0x0B, 0x07, 0x02, 0x9B, 0xFC, 0xDB, 0x2D, 0xCE, 0x28,
+    0xD9, 0x59, 0xF2, 0x81, 0x5B, 0x16, 0xF8, 0x17, 0x98
+};
+
+static void test_sha256_vectors() {
+    printf("\nSHA256 known answers\n");
+    check(hash_matches((const uint8_t*)"", 0,
+        "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855"), "empty message");
+    check(hash_matches((const uint8_t*)"abc", 3,
+        "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad"), "\"abc\"");
+    check(hash_matches((const uint8_t*)"abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq", 56,
+        "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1"), "two-block message");
+    check(hash_matches(test_pubkey, 33,
+        "0f715baf5d4c2ed329785cef29e562f73488c8a2bb9dbc5700b361d54b9b0554"), "generator pubkey");
+
+    // Incremental updates must match single-shot hashing at every split
+    uint8_t data[200], expected[32], hash[32];
+    fill_pattern(data, sizeof(data), 1);
+    SHA256::Hash(data, sizeof(data), expected);
+    bool ok = true;
+    for (size_t split = 0; split <= sizeof(data); split++) {
+        SHA256 sha;
+        sha.Update(data, split);
+        sha.Update(data + split, sizeof(data) - split);
+        sha.Final(hash);
+        ok &= memcmp(hash, expected, 32) == 0;
+    }
+    check(ok, "split Update matches single-shot Hash");
+}
+
+static void test_digest_layout() {
+    printf("\nDigest word layout\n");
+
+    uint8_t hash[32];
+    uint32_t words[8];
+    SHA256::Hash(test_pubkey, 33, hash);
+    SHA256 sha;
+    sha.Update(test_pubkey, 33);
+    sha.FinalWords(words);
+    check(words[0] == 0x0f715baf && words[7] == 0x4b9b0554, "FinalWords returns native state words");
+
+    // Batch conversion over counts that exercise the SIMD body and scalar tail
+    const size_t max_count = 37;
+    uint8_t bytes[max_count * 32], back[max_count * 32];
+    uint32_t batch_words[max_count * 8];
+    bool ok = true;
+    for (size_t count = 0; count <= max_count; count++) {
+        fill_pattern(bytes, count * 32, (uint32_t)count + 7);
+        DigestBytesToWords(bytes, batch_words, count);
+        for (size_t i = 0; i < count * 8; i++) {
+            const uint8_t* p = bytes + i * 4;
+            uint32_t expected = ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+            ok &= batch_words[i] == expected;
+        }
+        DigestWordsToBytes(batch_words, back, count);
+        ok &= memcmp(bytes, back, count * 32) == 0;
+    }
+    check(ok, "DigestBytesToWords / DigestWordsToBytes round trip");
+
+    // In-place conversion
+    uint8_t inplace[3 * 32];
+    fill_pattern(inplace, sizeof(inplace), 99);
+    memcpy(bytes, inplace, sizeof(inplace));
+    DigestBytesToWords(inplace, (uint32_t*)inplace, 3);
+    DigestWordsToBytes((uint32_t*)inplace, inplace, 3);
+    check(memcmp(bytes, inplace, sizeof(inplace)) == 0, "in-place conversion");
+
+    DigestWordsToBytes(words, bytes, 1);
+    check(memcmp(bytes, hash, 32) == 0, "FinalWords converts to Final bytes");
+}
+
+static void test_digest_compare() {
+    printf("\nDigest word comparison\n");
+
+    // Compare must order like memcmp on the byte layout
+    bool ok = true;
+    for (uint32_t trial = 0; trial < 2000; trial++) {
+        uint8_t a[32], b[32];
+        fill_pattern(a, 32, trial);
+        memcpy(b, a, 32);
+        if (trial % 4 != 0) {
+            size_t pos = trial % 32;
+            b[pos] ^= (uint8_t)(1 + (trial >> 5) % 255);
+        }
+        uint32_t wa[8], wb[8];
+        DigestBytesToWords(a, wa, 1);
+        DigestBytesToWords(b, wb, 1);
+        int expected = memcmp(a, b, 32);
+        expected = expected < 0 ? -1 : (expected > 0 ? 1 : 0);
+        ok &= DigestWordsCompare(wa, wb) == expected;
+        ok &= DigestWordsEqual(wa, wb) == (expected == 0);
+    }
+    check(ok, "DigestWordsCompare orders like memcmp");
+
+    const size_t count = 100;
+    uint32_t digests[count * 8];
+    fill_pattern((uint8_t*)digests, sizeof(digests), 5);
+    uint32_t target[8];
+    memcpy(target, digests + 17 * 8, 32);
+    memcpy(digests + 42 * 8, target, 32);
+    memcpy(digests + 99 * 8, target, 32);
+    digests[60 * 8] = target[0];  // first word matches only
+
+    uint32_t indices[4];
+    size_t found = DigestWordsFind(digests, count, target, indices, 4);
+    check(found == 3 && indices[0] == 17 && indices[1] == 42 && indices[2] == 99, "DigestWordsFind");
+    found = DigestWordsFind(digests, count, target, indices, 1);
+    check(found == 3 && indices[0] == 17, "DigestWordsFind reports total beyond capacity");
+}
+
+static bool ripemd160_matches(const char* message, const char* expected_hex) {
+    uint8_t expected[20], hash[20];
+    parse_hex(expected_hex, expected);
+    RIPEMD160::Hash((const uint8_t*)message, strlen(message), hash);
+    if (memcmp(hash, expected, 20) != 0) {
+        print_hex("  got     ", hash, 20);
+        printf("  expected: %s\n", expected_hex);
+        return false;
+    }
+    return true;
+}
+
+static void test_ripemd160() {
+    printf("\nRIPEMD-160\n");
+    check(ripemd160_matches("", "9c1185a5c5e9fc54612808977ee8f548b2258d31"), "empty message");
+    check(ripemd160_matches("abc", "8eb208f7e05d987a9b044a8e98c6b087f15a0bfc"), "\"abc\"");
+    check(ripemd160_matches("message digest", "5d0689ef49d2fae572b881b123a85ffa21595f36"), "\"message digest\"");
+    check(ripemd160_matches("abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq",
+        "12a053384a9c0c88e405a06c27dcf49ada62eb2b"), "two-block message");
+    check(ripemd160_matches("12345678901234567890123456789012345678901234567890123456789012345678901234567890",
+        "9b752e45573d4b39f4dbd3323cab82bf63326bfb"), "80-byte message");
+
+    // Lane-parallel compression against the scalar one
+    uint32_t x[16][RIPEMD160_LANES], state[5][RIPEMD160_LANES];
+    fill_pattern((uint8_t*)x, sizeof(x), 3);
+    fill_pattern((uint8_t*)state, sizeof(state), 4);
+    uint32_t expected[5][RIPEMD160_LANES];
+    for (int l = 0; l < RIPEMD160_LANES; l++) {
+        uint32_t lane_x[16], lane_state[5];
+        for (int i = 0; i < 16; i++) lane_x[i] = x[i][l];
+        for (int i = 0; i < 5; i++) lane_state[i] = state[i][l];
+        RIPEMD160TransformWords(lane_state, lane_x);
+        for (int i = 0; i < 5; i++) expected[i][l] = lane_state[i];
+    }
+    RIPEMD160TransformLanes(state, x);
+    check(memcmp(state, expected, sizeof(state)) == 0, "RIPEMD160TransformLanes matches scalar");
+}
+
+static void test_sha256_lanes() {
+    printf("\nLane-parallel SHA256\n");
+
+    const size_t max_len = 200;
+    uint8_t data[SHA256_LANES][64 + max_len];
+    for (int l = 0; l < SHA256_LANES; l++) {
+        fill_pattern(data[l], sizeof(data[l]), 10 + l);
+    }
+
+    bool ok = true;
+    for (size_t len = 0; len <= max_len; len++) {
+        const uint8_t* ptrs[SHA256_LANES];
+        for (int l = 0; l < SHA256_LANES; l++) ptrs[l] = data[l];
+        uint32_t out[8][SHA256_LANES];
+        SHA256HashLanes(SHA256_IV, 0, ptrs, len, out);
+        for (int l = 0; l < SHA256_LANES; l++) {
+            SHA256 sha;
+            sha.Update(data[l], len);
+            uint32_t words[8];
+            sha.FinalWords(words);
+            for (int i = 0; i < 8; i++) ok &= out[i][l] == words[i];
+        }
+    }
+    check(ok, "SHA256HashLanes matches SHA256 for lengths 0..200");
+
+    // Continue from a midstate reached after one block of each lane's data
+    uint32_t block[16][SHA256_LANES], mid[8][SHA256_LANES];
+    for (int l = 0; l < SHA256_LANES; l++) {
+        for (int i = 0; i < 16; i++) block[i][l] = ReadBE32(data[l] + i * 4);
+        for (int i = 0; i < 8; i++) mid[i][l] = SHA256_IV[i];
+    }
+    SHA256TransformLanes(mid, block);
+    ok = true;
+    for (int l = 0; l < SHA256_LANES; l++) {
+        uint32_t init[8];
+        for (int i = 0; i < 8; i++) init[i] = mid[i][l];
+        const uint8_t* ptrs[SHA256_LANES];
+        for (int k = 0; k < SHA256_LANES; k++) ptrs[k] = data[l] + 64;
+        uint32_t out[8][SHA256_LANES];
+        SHA256HashLanes(init, 64, ptrs, 77, out);
+        SHA256 sha;
+        sha.Update(data[l], 64 + 77);
+        uint32_t words[8];
+        sha.FinalWords(words);
+        for (int i = 0; i < 8; i++) ok &= out[i][0] == words[i] && out[i][SHA256_LANES - 1] == words[i];
+    }
+    check(ok, "SHA256HashLanes continues from a midstate");
+}
+
+static void test_hash160() {
+    printf("\nHash160\n");
+
+    uint8_t expected[20], hash[20];
+    parse_hex("751e76e8199196d454941c45d1b3a323f1433bd6", expected);
+    Hash160(test_pubkey, 33, hash);
+    check(memcmp(hash, expected, 20) == 0, "Hash160 of generator pubkey");
+
+    uint8_t sha[32];
+    SHA256::Hash(test_pubkey, 33, sha);
+    RIPEMD160::Hash(sha, 32, hash);
+    check(memcmp(hash, expected, 20) == 0, "RIPEMD160(SHA256(x)) agrees");
+
+    // Fused batch against the single-message path, including partial lane groups
+    const size_t lens[] = {0, 1, 32, 33, 55, 56, 64, 65, 119};
+    const size_t max_count = 19;
+    uint8_t data[max_count * 119];
+    uint8_t batch[max_count * 20];
+    bool ok = true;
+    for (size_t li = 0; li < sizeof(lens) / sizeof(lens[0]); li++) {
+        size_t len = lens[li];
+        fill_pattern(data, sizeof(data), (uint32_t)len);
+        for (size_t count = 1; count <= max_count; count++) {
+            Hash160Batch(data, len, batch, count);
+            for (size_t i = 0; i < count; i++) {
+                Hash160(data + i * len, len, hash);
+                ok &= memcmp(hash, batch + i * 20, 20) == 0;
+            }
+        }
+    }
+    check(ok, "Hash160Batch matches Hash160");
+}
+
+static void test_key_counter() {
+    printf("\nKey counter enumeration\n");
+
+    // Default layout reproduces the benchmark's generated keys
+    const size_t count = 600;
+    uint8_t keys[count * 33];
+    KeyCounterEnumerate(test_pubkey, KEY_COUNTER_DEFAULT_LAYOUT, 0, keys, count);
+    bool ok = true;
+    for (size_t i = 0; i < count; i++) {
+        uint8_t key[33];
+        memcpy(key, test_pubkey, 33);
+        key[31] = i & 0xFF;
+        key[32] = (i >> 8) & 0xFF;
+        ok &= memcmp(key, keys + i * 33, 33) == 0;
+    }
+    check(ok, "Default layout matches benchmark key generation");
+
+    // Counter wraps at the layout width; start offsets carry across bytes
+    uint8_t hashes[3 * 32], expected[32];
+    KeyCounterHashBatch(test_pubkey, KEY_COUNTER_DEFAULT_LAYOUT, 0xFFFF, hashes, 3);
+    SHA256::Hash(keys, 33, expected);
+    check(memcmp(hashes + 32, expected, 32) == 0, "Counter wraps after 2^16 keys");
+    SHA256::Hash(keys + 33, 33, expected);
+    ok = memcmp(hashes + 64, expected, 32) == 0;
+    SHA256::Hash(keys + 255 * 33, 33, expected);
+    KeyCounterHashBatch(test_pubkey, KEY_COUNTER_DEFAULT_LAYOUT, 255, hashes, 1);
+    ok &= memcmp(hashes, expected, 32) == 0;
+    check(ok, "KeyCounterHashBatch matches enumerated keys");
+
+    // Kernel view: base words with the counter bytes inserted per position
+    KeyCounterLayout wide = {8, {0, 5, 10, 15, 20, 25, 30, 32}};
+    uint64_t value = 0x0123456789ABCDEFULL;
+    uint32_t words[9];
+    KeyCounterBaseWords(test_pubkey, wide, words);
+    for (uint32_t i = 0; i < wide.num_bytes; i++) {
+        uint32_t pos = wide.positions[i];
+        words[pos / 4] |= (uint32_t)((value >> (8 * i)) & 0xFF) << ((3 - pos % 4) * 8);
+    }
+    uint8_t padded[36], key[33];
+    for (int i = 0; i < 9; i++) WriteBE32(padded + i * 4, words[i]);
+    KeyCounterEnumerate(test_pubkey, wide, value, key, 1);
+    check(memcmp(padded, key, 33) == 0 && padded[33] == 0x80 && padded[34] == 0 && padded[35] == 0,
+          "KeyCounterBaseWords + counter bytes give the padded key");
+
+    KeyCounterLayout dup = {2, {5, 5}};
+    KeyCounterLayout out_of_range = {1, {33}};
+    KeyCounterLayout empty = {0, {0}};
+    check(KeyCounterLayoutValid(KEY_COUNTER_DEFAULT_LAYOUT) && KeyCounterLayoutValid(wide) &&
+          !KeyCounterLayoutValid(dup) && !KeyCounterLayoutValid(out_of_range) && !KeyCounterLayoutValid(empty),
+          "KeyCounterLayoutValid");
+}
+
+static void test_prefix() {
+    printf("\nFixed-prefix rounds\n");
+
+    // The benchmark layout varies words 7 and 8: 7 rounds run once per batch
+    SHA256Prefix prefix;
+    KeyCounterPrefixInit(test_pubkey, KEY_COUNTER_DEFAULT_LAYOUT, prefix);
+    check(prefix.rounds == 7 && prefix.varying_words == 0x180, "Default layout precomputes 7 rounds");
+
+    // Lane batches match the plain enumeration for assorted layouts, starts
+    // and counts that leave a partial lane group
+    KeyCounterLayout layouts[] = {
+        KEY_COUNTER_DEFAULT_LAYOUT,
+        {1, {0}},
+        {1, {32}},
+        {3, {30, 12, 5}},
+        {8, {0, 5, 10, 15, 20, 25, 30, 32}},
+    };
+    const size_t count = 37;
+    uint8_t hashes[count * 32], expected[count * 32];
+    bool ok = true;
+    for (size_t n = 0; n < sizeof(layouts) / sizeof(layouts[0]); n++) {
+        uint64_t start = 0xFFFFFFFFFFFFFFF0ULL + n;
+        KeyCounterPrefixInit(test_pubkey, layouts[n], prefix);
+        KeyCounterPrefixHashBatch(prefix, layouts[n], start, hashes, count);
+        KeyCounterHashBatch(test_pubkey, layouts[n], start, expected, count);
+        ok &= memcmp(hashes, expected, sizeof(hashes)) == 0;
+    }
+    check(ok, "KeyCounterPrefixHashBatch matches KeyCounterHashBatch");
+
+    // Scalar path on a generic block: only word 3 varies
+    uint8_t block_bytes[64];
+    fill_pattern(block_bytes, 64, 7);
+    uint32_t block[16], out[8];
+    for (int i = 0; i < 16; i++) block[i] = ReadBE32(block_bytes + i * 4);
+    uint32_t nonce = block[3];
+    block[3] = 0;
+    SHA256PrefixInit(prefix, SHA256_IV, block, 1u << 3);
+    block[3] = nonce;
+    SHA256PrefixTransform(prefix, block, out);
+    uint32_t state[8];
+    memcpy(state, SHA256_IV, sizeof(state));
+    uint32_t lanes_state[8][SHA256_LANES], lanes_block[16][SHA256_LANES];
+    for (int i = 0; i < 8; i++) for (int l = 0; l < SHA256_LANES; l++) lanes_state[i][l] = SHA256_IV[i];
+    for (int i = 0; i < 16; i++) for (int l = 0; l < SHA256_LANES; l++) lanes_block[i][l] = block[i];
+    SHA256TransformLanes(lanes_state, lanes_block);
+    ok = prefix.rounds == 3;
+    for (int i = 0; i < 8; i++) ok &= out[i] == lanes_state[i][0];
+    check(ok, "SHA256PrefixTransform matches a full compression");
+}
+
+static void test_header_sweep() {
+    printf("\nBlock-header nonce sweep\n");
+
+    // Bitcoin genesis block header
+    uint8_t header[80];
+    parse_hex("01000000"
+              "0000000000000000000000000000000000000000000000000000000000000000"
+              "3ba3edfd7a7b12b27ac72c3e67768f617fc81bc3888a51323a9fb8aa4b1e5e4a"
+              "29ab5f49" "ffff001d" "1dac2b7c", header);
+    const uint32_t genesis_nonce = 2083236893;
+    uint8_t hash[32], expected[32];
+    parse_hex("6fe28c0ab6f1b372c1a6a246ae63f74f931e8365e15a089c68d6190000000000", expected);
+    HeaderHash(header, hash);
+    check(memcmp(hash, expected, 32) == 0, "HeaderHash of the genesis block");
+
+    uint8_t target[32];
+    HeaderTargetFromBits(0x1d00ffff, target);
+    bool ok = target[26] == 0xff && target[27] == 0xff && HeaderHashMeetsTarget(hash, target);
+    for (int i = 0; i < 32; i++) ok &= i == 26 || i == 27 || target[i] == 0;
+    check(ok, "HeaderTargetFromBits(0x1d00ffff) and genesis meets it");
+
+    uint32_t nonces[16];
+    size_t found = HeaderSweep(header, target, genesis_nonce - 1000, 2001, nonces, 16, 3);
+    check(found == 1 && nonces[0] == genesis_nonce, "Sweep around the genesis nonce finds exactly it");
+
+    // Easy target (top hash byte zero): compare with per-nonce SHA256d across
+    // the 2^32 wrap, with a thread count that leaves uneven shares
+    HeaderTargetFromBits(0x2000ffff, target);
+    const uint32_t start = 0xFFFFF000;
+    const size_t count = 5003;
+    uint32_t expected_nonces[64];
+    size_t num_expected = 0;
+    for (size_t i = 0; i < count; i++) {
+        uint32_t nonce = start + (uint32_t)i;
+        header[76] = (uint8_t)nonce;
+        header[77] = (uint8_t)(nonce >> 8);
+        header[78] = (uint8_t)(nonce >> 16);
+        header[79] = (uint8_t)(nonce >> 24);
+        HeaderHash(header, hash);
+        if (HeaderHashMeetsTarget(hash, target) && num_expected < 64) {
+            expected_nonces[num_expected++] = nonce;
+        }
+    }
+    uint32_t swept[64];
+    found = HeaderSweep(header, target, start, count, swept, 64, 4);
+    ok = found == num_expected && num_expected > 4;
+    for (size_t i = 0; ok && i < found; i++) ok &= swept[i] == expected_nonces[i];
+    check(ok, "Sweep matches per-nonce SHA256d");
+    found = HeaderSweep(header, target, start, count, swept, 4, 1);
+    check(found == num_expected && memcmp(swept, expected_nonces, 4 * sizeof(uint32_t)) == 0,
+          "Single-threaded sweep stores up to max_nonces and counts the rest");
+}
+
+static void test_node64() {
+    printf("\n64-byte node hashing\n");
+
+    // Child pairs as bytes; the batch takes them as native words (two
+    // digests per node) and must equal SHA256 of the 64 bytes
+    const size_t count = 19;
+    uint8_t nodes[count * 64], expected[count * 32], got[count * 32];
+    uint32_t words[count * 16], parents[count * 8];
+    fill_pattern(nodes, sizeof(nodes), 64);
+    for (size_t i = 0; i < count; i++) {
+        SHA256::Hash(nodes + i * 64, 64, expected + i * 32);
+    }
+    DigestBytesToWords(nodes, words, count * 2);
+
+    SHA256Node64Batch(words, parents, count);
+    DigestWordsToBytes(parents, got, count);
+    check(memcmp(got, expected, sizeof(got)) == 0, "SHA256Node64Batch matches SHA256 of 64 bytes");
+
+    SHA256Node64Batch(words, words, count);
+    DigestWordsToBytes(words, got, count);
+    check(memcmp(got, expected, sizeof(got)) == 0, "SHA256Node64Batch in place");
+}
+
+// Reference Merkle root: per-node SHA256d, odd levels duplicate their last node
+static void merkle_reference(const uint8_t* txids, size_t count, uint8_t root[32]) {
+    uint8_t* level = new uint8_t[(count + 1) * 32];
+    memcpy(level, txids, count * 32);
+    for (size_t n = count; n > 1; n = (n + 1) / 2) {
+        if (n & 1) memcpy(level + n * 32, level + (n - 1) * 32, 32);
+        for (size_t i = 0; i < (n + 1) / 2; i++) {
+            uint8_t first[32];
+            SHA256::Hash(level + i * 64, 64, first);
+            SHA256::Hash(first, 32, level + i * 32);
+        }
+    }
+    memcpy(root, level, 32);
+    delete[] level;
+}
+
+static void test_merkle() {
+    printf("\nMerkle root\n");
+
+    // SHA256d node batch against the scalar double hash
+    const size_t num_nodes = 11;
+    uint8_t nodes[num_nodes * 64], expected[num_nodes * 32], got[num_nodes * 32];
+    uint32_t words[num_nodes * 16], parents[num_nodes * 8];
+    fill_pattern(nodes, sizeof(nodes), 35);
+    for (size_t i = 0; i < num_nodes; i++) {
+        uint8_t first[32];
+        SHA256::Hash(nodes + i * 64, 64, first);
+        SHA256::Hash(first, 32, expected + i * 32);
+    }
+    DigestBytesToWords(nodes, words, num_nodes * 2);
+    SHA256dNode64Batch(words, parents, num_nodes);
+    DigestWordsToBytes(parents, got, num_nodes);
+    check(memcmp(got, expected, sizeof(got)) == 0, "SHA256dNode64Batch matches SHA256d of 64 bytes");
+
+    // Bitcoin block 100000: four transactions
+    uint8_t txids[4 * 32], root[32], block_root[32];
+    const char* display[4] = {
+        "8c14f0db3df150123e6f3dbbf30f8b955a8249b62ac1d1ff16284aefa3d06d87",
+        "fff2525b8931402dd09222c50775608f75787bd2b87e56995a7bdd30f79702c4",
+        "6359f0868171b1d194cbee1af2f16ea598ae8fad666d9b012c8ed2b79a236ec4",
+        "e9a66845e05d5abc0ad04ec80f774a7e585c6e8db975962d069a522137b80c1d",
+    };
+    for (int i = 0; i < 4; i++) {
+        uint8_t be[32];
+        parse_hex(display[i], be);
+        for (int j = 0; j < 32; j++) txids[i * 32 + j] = be[31 - j];
+    }
+    parse_hex("f3e94742aca4b5ef85488dc37c06c3282295ffec960994b2c0d5ac2a25a95766", root);
+    for (int j = 0; j < 16; j++) {
+        uint8_t t = root[j];
+        root[j] = root[31 - j];
+        root[31 - j] = t;
+    }
+    MerkleRoot(txids, 4, block_root);
+    check(memcmp(root, block_root, 32) == 0, "Merkle root of block 100000");
+
+    // Odd levels, single leaf, several thread counts, authentication paths
+    const size_t max_count = 5000;
+    uint8_t* leaves = new uint8_t[max_count * 32];
+    uint8_t path[32 * 16];
+    fill_pattern(leaves, max_count * 32, 100);
+    const size_t counts[] = {1, 2, 3, 5, 7, 8, 17, 100, max_count};
+    bool roots_ok = true, paths_ok = true;
+    for (size_t c = 0; c < sizeof(counts) / sizeof(counts[0]); c++) {
+        size_t count = counts[c];
+        merkle_reference(leaves, count, expected);
+        for (unsigned threads = 1; threads <= 3; threads += 2) {
+            size_t leaf = (count * 7 / 9) | (threads == 3 && count > 1);
+            if (leaf >= count) leaf = count - 1;
+            MerkleRoot(leaves, count, root, leaf, path, threads);
+            roots_ok &= memcmp(root, expected, 32) == 0;
+            MerkleRootFromPath(leaves + leaf * 32, leaf, path, MerkleDepth(count), got);
+            paths_ok &= memcmp(got, expected, 32) == 0;
+        }
+    }
+    check(roots_ok, "MerkleRoot matches per-node reference (odd levels, 1 and 3 threads)");
+    check(paths_ok, "Authentication paths fold back to the root");
+    check(MerkleDepth(0) == 0 && MerkleDepth(1) == 0 && MerkleDepth(2) == 1 && MerkleDepth(5) == 3,
+          "MerkleDepth");
+    MerkleRoot(leaves, 0, root);
+    bool zero = true;
+    for (int i = 0; i < 32; i++) zero &= root[i] == 0;
+    check(zero, "Empty list gives a zero root");
+    delete[] leaves;
+}
+
+static void test_merkle_tree() {
+    printf("\nIncremental Merkle tree\n");
+
+    const size_t max_count = 300;
+    uint8_t* leaves = new uint8_t[max_count * 32];
+    uint8_t root[32], expected[32], path[32 * 16];
+    fill_pattern(leaves, max_count * 32, 36);
+
+    // One append at a time, then batches, always agreeing with MerkleRoot
+    MerkleTree tree;
+    tree.Root(root);
+    bool zero = true;
+    for (int i = 0; i < 32; i++) zero &= root[i] == 0;
+    check(zero && tree.Size() == 0, "Empty tree has a zero root");
+
+    bool append_ok = true;
+    for (size_t n = 1; n <= 40; n++) {
+        tree.Append(leaves + (n - 1) * 32);
+        tree.Root(root);
+        MerkleRoot(leaves, n, expected);
+        append_ok &= tree.Size() == n && memcmp(root, expected, 32) == 0;
+    }
+    check(append_ok, "Append keeps the root equal to MerkleRoot");
+
+    tree.AppendBatch(leaves + 40 * 32, 61);
+    tree.AppendBatch(leaves + 101 * 32, max_count - 101);
+    tree.Root(root);
+    MerkleRoot(leaves, max_count, expected);
+    check(memcmp(root, expected, 32) == 0, "AppendBatch matches MerkleRoot");
+
+    // Single and batched updates, including siblings and a repeated index
+    uint8_t fresh[5 * 32];
+    fill_pattern(fresh, sizeof(fresh), 99);
+    tree.Update(max_count - 1, fresh);
+    memcpy(leaves + (max_count - 1) * 32, fresh, 32);
+    tree.Root(root);
+    MerkleRoot(leaves, max_count, expected);
+    check(memcmp(root, expected, 32) == 0, "Update of the last (odd) leaf");
+
+    const size_t indices[5] = {17, 16, 200, 3, 17};
+    tree.UpdateBatch(indices, fresh, 5);
+    for (int i = 0; i < 5; i++) memcpy(leaves + indices[i] * 32, fresh + i * 32, 32);
+    tree.Root(root);
+    MerkleRoot(leaves, max_count, expected);
+    check(memcmp(root, expected, 32) == 0, "UpdateBatch matches MerkleRoot (last duplicate wins)");
+
+    tree.UpdateBatch(NULL, NULL, 0);
+    tree.Root(root);
+    check(memcmp(root, expected, 32) == 0, "Empty UpdateBatch leaves the root alone");
+
+    bool paths_ok = true;
+    for (size_t leaf = 0; leaf < max_count; leaf += 23) {
+        tree.Path(leaf, path);
+        MerkleRootFromPath(leaves + leaf * 32, leaf, path, MerkleDepth(max_count), root);
+        paths_ok &= memcmp(root, expected, 32) == 0;
+    }
+    check(paths_ok, "Tree paths fold back to the root");
+
+    tree.Clear();
+    tree.Append(leaves);
+    tree.Root(root);
+    check(tree.Size() == 1 && memcmp(root, leaves, 32) == 0, "Clear, then a single leaf is its own root");
+    delete[] leaves;
+}
+
+// Reference tagged hash: the definition, spelled out
+static void tagged_hash_reference(const char* tag, const uint8_t* msg, size_t len, uint8_t hash[32]) {
+    uint8_t tag_hash[32];
+    SHA256::Hash((const uint8_t*)tag, strlen(tag), tag_hash);
+    SHA256 sha;
+    sha.Update(tag_hash, 32);
+    sha.Update(tag_hash, 32);
+    sha.Update(msg, len);
+    sha.Final(hash);
+}
+
+static void test_tagged_hash() {
+    printf("\nTagged hash\n");
+
+    // TapLeaf hash of leaf version 0xc0 with the script OP_TRUE
+    const uint8_t leaf[3] = {0xc0, 0x01, 0x51};
+    uint8_t expected[32], hash[32];
+    parse_hex("a85b2107f791b26a84e7586c28cec7cb61202ed3d01944d832500f363782d675", expected);
+    TaggedHash("TapLeaf", leaf, sizeof(leaf), hash);
+    check(memcmp(hash, expected, 32) == 0, "TapLeaf known answer");
+
+    check(&TaggedHashTagFor("TapLeaf") == &TaggedHashTagFor("TapLeaf"), "Tag midstate is cached per name");
+
+    // Message lengths around the padding boundaries, cached and explicit tags
+    uint8_t msg[200];
+    fill_pattern(msg, sizeof(msg), 37);
+    TaggedHashTag challenge;
+    TaggedHashTagInit(challenge, (const uint8_t*)"BIP0340/challenge", 17);
+    bool single_ok = true;
+    const size_t lengths[] = {0, 1, 32, 55, 56, 63, 64, 96, 119, 120, 200};
+    for (size_t i = 0; i < sizeof(lengths) / sizeof(lengths[0]); i++) {
+        tagged_hash_reference("BIP0340/challenge", msg, lengths[i], expected);
+        TaggedHash(challenge, msg, lengths[i], hash);
+        single_ok &= memcmp(hash, expected, 32) == 0;
+        TaggedHash("BIP0340/challenge", msg, lengths[i], hash);
+        single_ok &= memcmp(hash, expected, 32) == 0;
+    }
+    check(single_ok, "TaggedHash matches the definition (lengths 0..200)");
+
+    // Batch of 96-byte challenge messages (R || P || m) with a short last group
+    const size_t count = 21, len = 96;
+    uint8_t* msgs = new uint8_t[count * len];
+    uint8_t* hashes = new uint8_t[count * 32];
+    fill_pattern(msgs, count * len, 38);
+    TaggedHashBatch(challenge, msgs, len, hashes, count);
+    bool batch_ok = true;
+    for (size_t i = 0; i < count; i++) {
+        tagged_hash_reference("BIP0340/challenge", msgs + i * len, len, expected);
+        batch_ok &= memcmp(hashes + i * 32, expected, 32) == 0;
+    }
+    check(batch_ok, "TaggedHashBatch matches the definition");
+    delete[] msgs;
+    delete[] hashes;
+}
+
+// Reference HMAC straight from RFC 2104
+static void hmac_reference(const uint8_t* key, size_t key_len, const uint8_t* msg, size_t len, uint8_t mac[32]) {
+    uint8_t k[64] = {0}, pad[64], inner[32];
+    if (key_len > 64) {
+        SHA256::Hash(key, key_len, k);
+    } else {
+        memcpy(k, key, key_len);
+    }
+    SHA256 sha;
+    for (int i = 0; i < 64; i++) pad[i] = k[i] ^ 0x36;
+    sha.Update(pad, 64);
+    sha.Update(msg, len);
+    sha.Final(inner);
+    sha.Init();
+    for (int i = 0; i < 64; i++) pad[i] = k[i] ^ 0x5c;
+    sha.Update(pad, 64);
+    sha.Update(inner, 32);
+    sha.Final(mac);
+}
+
+static void test_hmac() {
+    printf("\nHMAC-SHA256\n");
+
+    // RFC 4231 test cases 1, 2 and 6 (key longer than a block)
+    uint8_t key[131], mac[32], expected[32];
+    memset(key, 0x0b, 20);
+    parse_hex("b0344c61d8db38535ca8afceaf0bf12b881dc200c9833da726e9376c2e32cff7", expected);
+    HMACSHA256(key, 20, (const uint8_t*)"Hi There", 8, mac);
+    check(memcmp(mac, expected, 32) == 0, "RFC 4231 case 1");
+
+    const char* jefe_msg = "what do ya want for nothing?";
+    parse_hex("5bdcc146bf60754e6a042426089575c75a003f089d2739839dec58b964ec3843", expected);
+    HMACSHA256((const uint8_t*)"Jefe", 4, (const uint8_t*)jefe_msg, strlen(jefe_msg), mac);
+    check(memcmp(mac, expected, 32) == 0, "RFC 4231 case 2");
+
+    const char* long_msg = "Test Using Larger Than Block-Size Key - Hash Key First";
+    memset(key, 0xaa, 131);
+    parse_hex("60e431591ee0b67f0d8a26aacbf5b77f8e0bc6213728c5140546040f0ee37f54", expected);
+    HMACSHA256(key, 131, (const uint8_t*)long_msg, strlen(long_msg), mac);
+    check(memcmp(mac, expected, 32) == 0, "RFC 4231 case 6 (131-byte key)");
+
+    // Cached key across message lengths, then the batch
+    uint8_t msg[150];
+    fill_pattern(key, 64, 38);
+    fill_pattern(msg, sizeof(msg), 39);
+    HMACSHA256Key k;
+    HMACSHA256KeyInit(k, key, 64);
+    bool single_ok = true;
+    const size_t lengths[] = {0, 1, 55, 56, 64, 100, 150};
+    for (size_t i = 0; i < sizeof(lengths) / sizeof(lengths[0]); i++) {
+        hmac_reference(key, 64, msg, lengths[i], expected);
+        HMACSHA256(k, msg, lengths[i], mac);
+        single_ok &= memcmp(mac, expected, 32) == 0;
+    }
+    check(single_ok, "Cached key matches RFC 2104 (64-byte key, lengths 0..150)");
+
+    const size_t count = 19, len = 45;
+    uint8_t* msgs = new uint8_t[count * len];
+    uint8_t* macs = new uint8_t[count * 32];
+    fill_pattern(msgs, count * len, 40);
+    HMACSHA256Batch(k, msgs, len, macs, count);
+    bool batch_ok = true;
+    for (size_t i = 0; i < count; i++) {
+        hmac_reference(key, 64, msgs + i * len, len, expected);
+        batch_ok &= memcmp(macs + i * 32, expected, 32) == 0;
+    }
+    check(batch_ok, "HMACSHA256Batch matches RFC 2104");
+    delete[] msgs;
+    delete[] macs;
+}
+
+static void test_pbkdf2() {
+    printf("\nPBKDF2-HMAC-SHA256\n");
+
+    // Known answers for password/salt and the 40-byte long-input case
+    uint8_t key[40], expected[40];
+    const uint8_t* pw = (const uint8_t*)"password";
+    const uint8_t* salt = (const uint8_t*)"salt";
+    parse_hex("120fb6cffcf8b32c43e7225256c4f837a86548c92ccc35480805987cb70be17b", expected);
+    PBKDF2HMACSHA256(pw, 8, salt, 4, 1, key, 32);
+    check(memcmp(key, expected, 32) == 0, "1 iteration");
+    parse_hex("ae4d0c95af6b46d32d0adff928f06dd02a303f8ef3c251dfd6e2d85a95474c43", expected);
+    PBKDF2HMACSHA256(pw, 8, salt, 4, 2, key, 32);
+    check(memcmp(key, expected, 32) == 0, "2 iterations");
+    parse_hex("c5e478d59288c841aa530db6845c4c8d962893a001ce4e11a4963873aa98134a", expected);
+    PBKDF2HMACSHA256(pw, 8, salt, 4, 4096, key, 32);
+    check(memcmp(key, expected, 32) == 0, "4096 iterations");
+
+    const char* long_pw = "passwordPASSWORDpassword";
+    const char* long_salt = "saltSALTsaltSALTsaltSALTsaltSALTsalt";
+    parse_hex("348c89dbcbd32b2f32d814b8116e84cf2b17347ebc1800181c4e2a1fb8dd53e1c635518c7dac47e9", expected);
+    PBKDF2HMACSHA256((const uint8_t*)long_pw, strlen(long_pw), (const uint8_t*)long_salt, strlen(long_salt),
+                     4096, key, 40);
+    check(memcmp(key, expected, 40) == 0, "4096 iterations, 40-byte key over two blocks");
+
+    // Batch of jobs with mixed password, salt and key lengths (some longer
+    // than one block), on 1 and 3 threads, against single derivations
+    const size_t num_jobs = 13;
+    const uint32_t iterations = 50;
+    uint8_t secrets[num_jobs * 80], derived[num_jobs * 70], single[70];
+    fill_pattern(secrets, sizeof(secrets), 41);
+    PBKDF2Job jobs[num_jobs];
+    bool batch_ok = true;
+    for (unsigned threads = 1; threads <= 3; threads += 2) {
+        memset(derived, 0, sizeof(derived));
+        for (size_t i = 0; i < num_jobs; i++) {
+            PBKDF2Job job = {secrets + i * 80, i * 7 % 80, secrets + i * 80 + 40, i % 40,
+                             derived + i * 70, 1 + i * 11 % 70};
+            jobs[i] = job;
+        }
+        PBKDF2HMACSHA256Batch(jobs, num_jobs, iterations, threads);
+        for (size_t i = 0; i < num_jobs; i++) {
+            PBKDF2HMACSHA256(jobs[i].password, jobs[i].password_len, jobs[i].salt, jobs[i].salt_len,
+                             iterations, single, jobs[i].key_len);
+            batch_ok &= memcmp(derived + i * 70, single, jobs[i].key_len) == 0;
+        }
+    }
+    check(batch_ok, "PBKDF2HMACSHA256Batch matches single derivations (1 and 3 threads)");
+}
+
+static void test_hkdf() {
+    printf("\nHKDF-SHA256\n");
+
+    // RFC 5869 test case 1
+    uint8_t ikm[22], salt[13], info[10], prk[32], okm[42], expected[42];
+    memset(ikm, 0x0b, sizeof(ikm));
+    for (int i = 0; i < 13; i++) salt[i] = (uint8_t)i;
+    for (int i = 0; i < 10; i++) info[i] = (uint8_t)(0xf0 + i);
+    HKDFExtract(salt, sizeof(salt), ikm, sizeof(ikm), prk);
+    parse_hex("077709362c2e32df0ddc3f0dc47bba6390b6c73bb50f9c3122ec844ad7c2b3e5", expected);
+    check(memcmp(prk, expected, 32) == 0, "RFC 5869 case 1 PRK");
+    parse_hex("3cb25f25faacd57a90434f64d0362f2a2d2d0a90cf1a5a4c5db02d56ecc4c5bf34007208d5b887185865",
+              expected);
+    check(HKDFExpand(prk, 32, info, sizeof(info), okm, 42) && memcmp(okm, expected, 42) == 0,
+          "RFC 5869 case 1 OKM");
+
+    // Streaming the same output in uneven pieces
+    HKDFExpander ctx;
+    HKDFExpandInit(ctx, prk, 32, info, sizeof(info));
+    memset(okm, 0, sizeof(okm));
+    bool ok = HKDFExpandRead(ctx, okm, 5) && HKDFExpandRead(ctx, okm + 5, 0) &&
+              HKDFExpandRead(ctx, okm + 5, 27) && HKDFExpandRead(ctx, okm + 32, 10);
+    check(ok && memcmp(okm, expected, 42) == 0, "Streamed expand matches one-shot");
+
+    // RFC 5869 test case 3: empty salt and info
+    parse_hex("8da4e775a563c18f715f802a063c5a31b8a11f5c5ee1879ec3454e5f3c738d2d9d201395faa4b61a96c8",
+              expected);
+    check(HKDF(NULL, 0, ikm, sizeof(ikm), NULL, 0, okm, 42) && memcmp(okm, expected, 42) == 0,
+          "RFC 5869 case 3 (empty salt and info)");
+
+    // Output limit of 255 blocks
+    uint8_t* big = new uint8_t[HKDF_MAX_OUTPUT + 1];
+    check(!HKDFExpand(prk, 32, info, sizeof(info), big, HKDF_MAX_OUTPUT + 1), "Expand past 255 blocks fails");
+    HKDFExpandInit(ctx, prk, 32, info, sizeof(info));
+    ok = HKDFExpandRead(ctx, big, HKDF_MAX_OUTPUT - 1) && HKDFExpandRead(ctx, big, 1) &&
+         !HKDFExpandRead(ctx, big, 1);
+    check(ok, "Streaming stops exactly at the limit");
+    delete[] big;
+}
+
+static void test_sha512_family() {
+    printf("\nSHA-224 and SHA-512 family\n");
+
+    const uint8_t* abc = (const uint8_t*)"abc";
+    uint8_t hash[64], expected[64];
+
+    parse_hex("23097d223405d8228642a477bda255b32aadbce4bda0b3f7e36c9da7", expected);
+    SHA224::Hash(abc, 3, hash);
+    check(memcmp(hash, expected, 28) == 0, "SHA-224(\"abc\")");
+
+    parse_hex("ddaf35a193617abacc417349ae20413112e6fa4e89a97ea20a9eeee64b55d39a"
+              "2192992a274fc1a836ba3c23a3feebbd454d4423643ce80e2a9ac94fa54ca49f", expected);
+    SHA512::Hash(abc, 3, hash);
+    check(memcmp(hash, expected, 64) == 0, "SHA-512(\"abc\")");
+
+    parse_hex("53048e2681941ef99b2e29b76b4c7dabe4c2d0c634fc6d46e0e2f13107e7af23", expected);
+    SHA512_256::Hash(abc, 3, hash);
+    check(memcmp(hash, expected, 32) == 0, "SHA-512/256(\"abc\")");
+
+    // 112 bytes: the length no longer fits, so padding takes a second block.
+    // Fed in uneven pieces to cross the buffer boundary.
+    const char* two_block = "abcdefghbcdefghicdefghijdefghijkefghijklfghijklmghijklmn"
+                            "hijklmnoijklmnopjklmnopqklmnopqrlmnopqrsmnopqrstnopqrstu";
+    parse_hex("8e959b75dae313da8cf4f72814fc143f8f7779c6eb9f7fa17299aeadb6889018"
+              "501d289e4900f7e4331b99dec4b5433ac7d329eeb6dd26545e96e55b874be909", expected);
+    SHA512 sha;
+    sha.Update((const uint8_t*)two_block, 50);
+    sha.Update((const uint8_t*)two_block + 50, 62);
+    sha.Final(hash);
+    check(memcmp(hash, expected, 64) == 0, "SHA-512 of 112 bytes in two updates");
+
+    // Lanes against the scalar classes, lengths across both padding cases
+    uint8_t data[SHA512_LANES * 300];
+    fill_pattern(data, sizeof(data), 41);
+    const uint8_t* lane_data[SHA512_LANES];
+    uint64_t out[8][SHA512_LANES];
+    bool lanes_ok = true;
+    for (size_t len = 0; len <= 300; len += 37) {
+        for (int l = 0; l < SHA512_LANES; l++) lane_data[l] = data + l * 300;
+        SHA512HashLanes(SHA512_IV, 0, lane_data, len, out);
+        for (int l = 0; l < SHA512_LANES; l++) {
+            SHA512::Hash(lane_data[l], len, expected);
+            for (int i = 0; i < 8; i++) WriteBE64(hash + i * 8, out[i][l]);
+            lanes_ok &= memcmp(hash, expected, 64) == 0;
+        }
+        SHA512HashLanes(SHA512_256_IV, 0, lane_data, len, out);
+        for (int l = 0; l < SHA512_LANES; l++) {
+            SHA512_256::Hash(lane_data[l], len, expected);
+            for (int i = 0; i < 4; i++) WriteBE64(hash + i * 8, out[i][l]);
+            lanes_ok &= memcmp(hash, expected, 32) == 0;
+        }
+    }
+    check(lanes_ok, "SHA512HashLanes matches SHA-512 and SHA-512/256");
+
+    const uint8_t* lane_data32[SHA256_LANES];
+    uint32_t out32[8][SHA256_LANES];
+    for (int l = 0; l < SHA256_LANES; l++) lane_data32[l] = data + l * 37;
+    SHA256HashLanes(SHA224_IV, 0, lane_data32, 100, out32);
+    bool sha224_ok = true;
+    for (int l = 0; l < SHA256_LANES; l++) {
+        SHA224::Hash(lane_data32[l], 100, expected);
+        for (int i = 0; i < 7; i++) WriteBE32(hash + i * 4, out32[i][l]);
+        sha224_ok &= memcmp(hash, expected, 28) == 0;
+    }
+    check(sha224_ok, "SHA256HashLanes from SHA224_IV matches SHA-224");
+
+    // HMAC-SHA512: RFC 4231 cases 1 and 6, BIP32 master key, batch
+    uint8_t key[131];
+    memset(key, 0x0b, 20);
+    parse_hex("87aa7cdea5ef619d4ff0b4241a1d6cb02379f4e2ce4ec2787ad0b30545e17cde"
+              "daa833b7d6b8a702038b274eaea3f4e4be9d914eeb61f1702e696c203a126854", expected);
+    HMACSHA512(key, 20, (const uint8_t*)"Hi There", 8, hash);
+    check(memcmp(hash, expected, 64) == 0, "HMAC-SHA512 RFC 4231 case 1");
+
+    const char* long_msg = "Test Using Larger Than Block-Size Key - Hash Key First";
+    memset(key, 0xaa, 131);
+    parse_hex("80b24263c7c1a3ebb71493c1dd7be8b49b46d1f41b4aeec1121b013783f8f352"
+              "6b56d037e05f2598bd0fd2215d6a1e5295e64f73f63f0aec8b915a985d786598", expected);
+    HMACSHA512(key, 131, (const uint8_t*)long_msg, strlen(long_msg), hash);
+    check(memcmp(hash, expected, 64) == 0, "HMAC-SHA512 RFC 4231 case 6 (131-byte key)");
+
+    uint8_t seed[16];
+    for (int i = 0; i < 16; i++) seed[i] = (uint8_t)i;
+    parse_hex("e8f32e723decf4051aefac8e2c93c9c5b214313817cdb01a1494b917c8436b35"
+              "873dff81c02f525623fd1fe5167eac3a55a049de3d314bb42ee227ffed37d508", expected);
+    HMACSHA512((const uint8_t*)"Bitcoin seed", 12, seed, 16, hash);
+    check(memcmp(hash, expected, 64) == 0, "BIP32 test vector 1 master key and chain code");
+
+    const size_t count = 11, len = 37;
+    uint8_t msgs[count * len], macs[count * 64];
+    fill_pattern(msgs, sizeof(msgs), 42);
+    HMACSHA512Key k;
+    HMACSHA512KeyInit(k, seed, 16);
+    HMACSHA512Batch(k, msgs, len, macs, count);
+    bool batch_ok = true;
+    for (size_t i = 0; i < count; i++) {
+        HMACSHA512(seed, 16, msgs + i * len, len, expected);
+        batch_ok &= memcmp(macs + i * 64, expected, 64) == 0;
+    }
+    check(batch_ok, "HMACSHA512Batch matches single MACs");
+}
+
+// Evaluated by the compiler; a wrong digest fails the build
+static constexpr SHA256ConstDigest const_abc = SHA256ConstHash("abc");
+static constexpr SHA256ConstDigest const_pubkey = SHA256ConstHash(test_pubkey, 33);
+static_assert(const_abc[0] == 0xba7816bf && const_abc[7] == 0xf20015ad, "constexpr SHA256(\"abc\")");
+static_assert(const_pubkey[0] == 0x0f715baf && const_pubkey[7] == 0x4b9b0554, "constexpr generator pubkey");
+
+static void test_constexpr() {
+    printf("\nCompile-time SHA256\n");
+
+    // Every length around the padding boundaries, against the runtime class
+    static constexpr char text[] =
+        "The quick brown fox jumps over the lazy dog. The quick brown fox jumps over the lazy dog. "
+        "The quick brown fox jumps over the lazy dog.";
+    uint32_t words[8];
+    bool hash_ok = true;
+    for (size_t len = 0; len <= sizeof(text) - 1; len++) {
+        SHA256ConstDigest digest = SHA256ConstHash(text, len);
+        SHA256 sha;
+        sha.Update((const uint8_t*)text, len);
+        sha.FinalWords(words);
+        hash_ok &= memcmp(digest.w, words, 32) == 0;
+    }
+    check(hash_ok, "SHA256ConstHash matches SHA256 for lengths 0..134");
+
+    // Midstate and continuation
+    static constexpr SHA256ConstDigest mid = SHA256ConstMidstate(text, 128);
+    static constexpr SHA256ConstDigest cont = SHA256ConstHash(text + 128, 6, mid, 128);
+    SHA256 sha;
+    sha.Update((const uint8_t*)text, 128);
+    sha.Midstate(words);
+    bool mid_ok = memcmp(mid.w, words, 32) == 0;
+    sha.Update((const uint8_t*)text + 128, 6);
+    sha.FinalWords(words);
+    check(mid_ok && memcmp(cont.w, words, 32) == 0, "Midstate and continuation match SHA256");
+
+    uint8_t bytes[32];
+    SHA256::Hash(test_pubkey, 33, bytes);
+    bool bytes_ok = true;
+    for (int i = 0; i < 32; i++) bytes_ok &= const_pubkey.Byte(i) == bytes[i];
+    check(bytes_ok, "Byte() gives the big-endian digest");
+
+    static constexpr TaggedHashTag tapleaf = TaggedHashConstTag("TapLeaf");
+    check(memcmp(tapleaf.midstate, TaggedHashTagFor("TapLeaf").midstate, 32) == 0,
+          "Compile-time tag midstate matches the cached one");
+}
+
+// Message words of a fixed-length shape: big-endian, zero past the end
+static void load_shape_words(const uint8_t* msg, size_t len, uint32_t* words, size_t count) {
+    memset(words, 0, count * 4);
+    for (size_t i = 0; i < len; i++) {
+        words[i / 4] |= (uint32_t)msg[i] << (24 - 8 * (i % 4));
+    }
+}
+
+static bool shape_matches(void (*shape)(uint32_t*, const uint32_t*), size_t len, size_t data_words) {
+    uint8_t msg[80], expected[32], got[32];
+    uint32_t words[20], state[8];
+    bool ok = true;
+    for (uint32_t seed = 1; seed <= 16; seed++) {
+        fill_pattern(msg, len, seed);
+        load_shape_words(msg, len, words, data_words);
+        memcpy(state, SHA256_IV, 32);
+        shape(state, words);
+        for (int i = 0; i < 8; i++) WriteBE32(got + i * 4, state[i]);
+        SHA256::Hash(msg, len, expected);
+        ok &= memcmp(got, expected, 32) == 0;
+    }
+    return ok;
+}
+
+static void test_shapes() {
+    printf("\nGenerated fixed-length shapes\n");
+
+    check(shape_matches(SHA256ShapeKey33<uint32_t>, 33, SHA256_SHAPE_KEY33_DATA_WORDS),
+          "33-byte shape matches SHA256");
+    check(shape_matches(SHA256ShapeDigest32<uint32_t>, 32, SHA256_SHAPE_DIGEST32_DATA_WORDS),
+          "32-byte shape matches SHA256");
+    check(shape_matches(SHA256ShapeNode64<uint32_t>, 64, SHA256_SHAPE_NODE64_DATA_WORDS),
+          "64-byte shape matches SHA256");
+    check(shape_matches(SHA256ShapeHeader80<uint32_t>, 80, SHA256_SHAPE_HEADER80_DATA_WORDS),
+          "80-byte shape matches SHA256");
+
+    // The same template on four lanes
+    uint8_t keys[4][33], expected[32];
+    uint32_t words[9];
+    SHA256Vec4 data[9], state[8];
+    for (int l = 0; l < 4; l++) {
+        fill_pattern(keys[l], 33, 100 + l);
+        load_shape_words(keys[l], 33, words, 9);
+        for (int i = 0; i < 9; i++) data[i][l] = words[i];
+    }
+    for (int i = 0; i < 8; i++) state[i] = SHA256Vec4() + SHA256_IV[i];
+    SHA256ShapeKey33(state, data);
+    bool lanes_ok = true;
+    for (int l = 0; l < 4; l++) {
+        SHA256::Hash(keys[l], 33, expected);
+        for (int i = 0; i < 8; i++) lanes_ok &= state[i][l] == ReadBE32(expected + i * 4);
+    }
+    check(lanes_ok, "33-byte shape on 4 lanes matches SHA256");
+}
+
+static void test_arena() {
+    printf("\nPacked variable-length arena\n");
+
+    // Shuffled lengths 0..299: one to five blocks, every padding boundary
+    const size_t num_msgs = 300;
+    static uint8_t data[num_msgs * num_msgs];
+    const uint8_t* msgs[num_msgs];
+    size_t lens[num_msgs];
+    fill_pattern(data, sizeof(data), 46);
+    for (size_t i = 0; i < num_msgs; i++) {
+        lens[i] = (i * 7) % num_msgs;
+        msgs[i] = data + i * num_msgs;
+    }
+    SHA256Arena arena;
+    check(SHA256ArenaPack(arena, msgs, lens, num_msgs) && arena.entries.size() == num_msgs,
+          "SHA256ArenaPack packs every message");
+
+    bool sorted = true, bytes_ok = true;
+    for (size_t i = 0; i < num_msgs; i++) {
+        const SHA256ArenaEntry& e = arena.entries[i];
+        bytes_ok &= e.length == lens[e.index] && memcmp(arena.bytes.data() + e.offset, msgs[e.index], e.length) == 0;
+        if (i > 0) {
+            const SHA256ArenaEntry& prev = arena.entries[i - 1];
+            uint64_t blocks = SHA256BlockCount(e.length), prev_blocks = SHA256BlockCount(prev.length);
+            sorted &= prev_blocks < blocks || (prev_blocks == blocks && prev.index < e.index);
+            bytes_ok &= e.offset == prev.offset + prev.length;
+        }
+    }
+    check(bytes_ok, "Entries locate each message in the arena");
+    check(sorted, "Entries are bucketed by block count, stable within a bucket");
+
+    static uint8_t hashes[num_msgs * 32];
+    uint8_t expected[32];
+    SHA256ArenaHash(arena, hashes);
+    bool hash_ok = true;
+    for (size_t i = 0; i < num_msgs; i++) {
+        SHA256::Hash(msgs[i], lens[i], expected);
+        hash_ok &= memcmp(hashes + i * 32, expected, 32) == 0;
+    }
+    check(hash_ok, "SHA256ArenaHash matches SHA256 in the caller's order");
+
+    size_t too_long = (size_t)SHA256_ARENA_MAX_MESSAGE + 1;
+    check(!SHA256ArenaPack(arena, msgs, &too_long, 1), "Messages over SHA256_ARENA_MAX_MESSAGE are refused");
+}
+
+static void test_batch() {
+    printf("\nMixed-length batches\n");
+
+    // Long tail: mostly short messages, every 11th one up to 4 KB; enough
+    // blocks in all for three threads
+    const size_t num_msgs = 3000;
+    const size_t max_len = 4096;
+    static uint8_t data[max_len + num_msgs];
+    const uint8_t* msgs[num_msgs];
+    size_t lens[num_msgs];
+    fill_pattern(data, sizeof(data), 47);
+    for (size_t i = 0; i < num_msgs; i++) {
+        lens[i] = i % 11 == 0 ? (i * 131) % (max_len + 1) : (i * 7) % 150;
+        msgs[i] = data + i;
+    }
+
+    static uint8_t expected[num_msgs * 32];
+    for (size_t i = 0; i < num_msgs; i++) {
+        SHA256::Hash(msgs[i], lens[i], expected + i * 32);
+    }
+
+    static uint8_t hashes[num_msgs * 32];
+    SHA256HashBatch(msgs, lens, num_msgs, hashes, 1);
+    check(memcmp(hashes, expected, sizeof(hashes)) == 0, "SHA256HashBatch matches SHA256 (1 thread)");
+
+    memset(hashes, 0, sizeof(hashes));
+    SHA256HashBatch(msgs, lens, num_msgs, hashes, 3);
+    check(memcmp(hashes, expected, sizeof(hashes)) == 0, "SHA256HashBatch matches SHA256 (3 threads)");
+
+    // Two long messages on four threads: a share per message, no empty ones
+    static uint8_t long_data[600000];
+    fill_pattern(long_data, sizeof(long_data), 147);
+    const uint8_t* long_msgs[2] = {long_data, long_data + 1};
+    size_t long_lens[2] = {600000, 599999};
+    uint8_t long_expected[64];
+    SHA256::Hash(long_msgs[0], long_lens[0], long_expected);
+    SHA256::Hash(long_msgs[1], long_lens[1], long_expected + 32);
+    memset(hashes, 0, sizeof(hashes));
+    SHA256HashBatch(long_msgs, long_lens, 2, hashes, 4);
+    check(memcmp(hashes, long_expected, 64) == 0, "SHA256HashBatch gives threads only non-empty shares");
+
+    // Fewer messages than lanes
+    memset(hashes, 0, sizeof(hashes));
+    SHA256HashBatch(msgs, lens, 3, hashes);
+    check(memcmp(hashes, expected, 3 * 32) == 0, "SHA256HashBatch handles a batch smaller than the lanes");
+}
+
+static void test_job_manager() {
+    printf("\nMulti-buffer job manager\n");
+
+    const size_t num_jobs = 200;
+    static uint8_t data[1000 + num_jobs];
+    static SHA256Job jobs[num_jobs];
+    fill_pattern(data, sizeof(data), 48);
+
+    SHA256JobManager mgr;
+    check(mgr.Flush() == NULL && mgr.Pending() == 0, "Flush of an empty manager returns NULL");
+
+    // Submit one at a time; completed jobs come back as they finish
+    size_t returned[num_jobs];
+    size_t num_returned = 0;
+    for (size_t i = 0; i < num_jobs; i++) {
+        jobs[i].msg = data + i;
+        jobs[i].len = i % 5 == 0 ? (i * 53) % 1000 : i % 70;
+        jobs[i].user_data = &jobs[i];
+        SHA256Job* job = mgr.Submit(&jobs[i]);
+        if (job) {
+            returned[num_returned++] = job - jobs;
+        }
+    }
+    bool flushed_before_end = num_returned > 0;
+    while (SHA256Job* job = mgr.Flush()) {
+        returned[num_returned++] = job - jobs;
+    }
+    check(flushed_before_end && mgr.Pending() == 0, "Submit hands back jobs before the flush");
+
+    bool seen[num_jobs] = {};
+    bool once = num_returned == num_jobs, hash_ok = true, out_of_order = false;
+    uint8_t expected[32];
+    for (size_t k = 0; k < num_returned && once; k++) {
+        size_t i = returned[k];
+        once &= !seen[i] && jobs[i].user_data == &jobs[i];
+        seen[i] = true;
+        SHA256::Hash(jobs[i].msg, jobs[i].len, expected);
+        hash_ok &= memcmp(jobs[i].hash, expected, 32) == 0;
+        out_of_order |= k > 0 && i < returned[k - 1];
+    }
+    check(once, "Every job comes back exactly once");
+    check(hash_ok, "Job hashes match SHA256");
+    check(out_of_order, "Short jobs overtake long ones");
+
+    // Fewer jobs than lanes: nothing completes until the flush
+    check(mgr.Submit(&jobs[1]) == NULL && mgr.Submit(&jobs[2]) == NULL && mgr.Pending() == 2,
+          "Submit waits while lanes are free");
+    SHA256Job* first = mgr.Flush();
+    SHA256Job* second = mgr.Flush();
+    check(first && second && first != second && mgr.Flush() == NULL, "Flush drains partly filled lanes");
+}
+
+static void test_update_v() {
+    printf("\nScatter-gather Update\n");
+
+    static uint8_t data[1000];
+    uint8_t expected[32], hash[32];
+    fill_pattern(data, sizeof(data), 49);
+    SHA256::Hash(data, sizeof(data), expected);
+
+    // Header, body and trailer split at every offset class, with empty
+    // fragments in between
+    bool ok = true;
+    for (size_t a = 0; a < 140; a++) {
+        size_t b = a + (a * 37) % 300;
+        SHA256Fragment frags[5] = {
+            {data, a}, {data + a, 0}, {data + a, b - a}, {data + b, sizeof(data) - b - 3}, {data + sizeof(data) - 3, 3}
+        };
+        SHA256 sha;
+        sha.UpdateV(frags, 5);
+        sha.Final(hash);
+        ok &= memcmp(hash, expected, 32) == 0;
+    }
+    check(ok, "UpdateV matches a single Update");
+
+    // Continues a partial block left by Update, and leaves one for Update
+    SHA256Fragment frags[3] = {{data + 5, 20}, {data + 25, 150}, {data + 175, 1}};
+    SHA256 sha;
+    sha.Update(data, 5);
+    sha.UpdateV(frags, 3);
+    sha.Update(data + 176, sizeof(data) - 176);
+    sha.Final(hash);
+    check(memcmp(hash, expected, 32) == 0, "UpdateV interleaves with Update");
+
+    sha.Init();
+    sha.UpdateV(NULL, 0);
+    sha.Final(hash);
+    SHA256::Hash(data, 0, expected);
+    check(memcmp(hash, expected, 32) == 0, "UpdateV with no fragments is a no-op");
+}
+
+static void test_save_restore() {
+    printf("\nSaved hashing state\n");
+
+    static uint8_t data[1000];
+    uint8_t expected[32], hash[32];
+    fill_pattern(data, sizeof(data), 50);
+    SHA256::Hash(data, sizeof(data), expected);
+
+    // Checkpoint at every tail length, resume in a fresh object
+    bool ok = true;
+    for (size_t split = 0; split < 200; split += 3) {
+        uint8_t saved[SHA256_SAVED_BYTES];
+        SHA256 sha;
+        sha.Update(data, split);
+        sha.Save(saved);
+        SHA256 resumed;
+        resumed.Update(data, 7);
+        ok &= resumed.Restore(saved);
+        resumed.Update(data + split, sizeof(data) - split);
+        resumed.Final(hash);
+        ok &= memcmp(hash, expected, 32) == 0;
+    }
+    check(ok, "Restore resumes a saved hash");
+
+    // Version 1 layout of "abc" is fixed
+    uint8_t saved[SHA256_SAVED_BYTES];
+    SHA256 sha;
+    sha.Update((const uint8_t*)"abc", 3);
+    sha.Save(saved);
+    static const uint8_t head[20] = {'S', '2', '5', '6', 1, 3, 0, 0, 0, 0, 0, 0, 0, 0, 0, 3,
+                                     0x6a, 0x09, 0xe6, 0x67};
+    bool tail_zero = true;
+    for (size_t i = 51; i < SHA256_SAVED_BYTES; i++) {
+        tail_zero &= saved[i] == 0;
+    }
+    check(memcmp(saved, head, sizeof(head)) == 0 && memcmp(saved + 48, "abc", 3) == 0 && tail_zero,
+          "Saved layout matches version 1");
+
+    uint8_t bad[SHA256_SAVED_BYTES];
+    memcpy(bad, saved, sizeof(bad));
+    bad[4] = SHA256_SAVED_VERSION + 1;
+    bool rejected = !sha.Restore(bad);
+    memcpy(bad, saved, sizeof(bad));
+    bad[0] = 's';
+    rejected &= !sha.Restore(bad);
+    memcpy(bad, saved, sizeof(bad));
+    bad[5] = 4;
+    rejected &= !sha.Restore(bad);
+    memcpy(bad, saved, sizeof(bad));
+    bad[48 + 3] = 1;
+    rejected &= !sha.Restore(bad);
+    memcpy(bad, saved, sizeof(bad));
+    bad[SHA256_SAVED_BYTES - 1] = 0x80;
+    rejected &= !sha.Restore(bad);
+    sha.Final(hash);
+    SHA256::Hash((const uint8_t*)"abc", 3, expected);
+    check(rejected && memcmp(hash, expected, 32) == 0, "Bad magic, version, tail or fill is refused, state unchanged");
+}
+
+static void test_target_filter() {
+    printf("\nTarget filter\n");
+
+    TargetFilter filter;
+    filter.Init(1000);
+    check(filter.NumBlocks() == 64 && filter.SizeBytes() == 64 * 32, "Init rounds blocks up to a power of two");
+
+    // Digests of pattern keys; every third one is a target
+    const size_t count = 3000;
+    uint8_t* keys = new uint8_t[count * 33];
+    uint32_t* digests = new uint32_t[count * 8];
+    fill_pattern(keys, count * 33, 42);
+    for (size_t i = 0; i < count; i++) {
+        SHA256 sha;
+        sha.Update(keys + i * 33, 33);
+        sha.FinalWords(digests + i * 8);
+    }
+    for (size_t i = 0; i < count; i += 3) {
+        filter.Insert(digests + i * 8);
+    }
+
+    bool ok = true;
+    for (size_t i = 0; i < count; i += 3) {
+        ok &= filter.MayContain(digests + i * 8);
+    }
+    check(ok, "No false negatives");
+
+    // False positive rate on unrelated digests
+    uint32_t probe[8];
+    size_t false_positives = 0;
+    const size_t probes = 200000;
+    for (size_t i = 0; i < probes; i++) {
+        fill_pattern((uint8_t*)probe, sizeof(probe), (uint32_t)(1000 + i));
+        false_positives += filter.MayContain(probe);
+    }
+    printf("  false positive rate: %.4f%%\n", 100.0 * false_positives / probes);
+    check(false_positives < probes / 200, "False positive rate below 0.5% at 16 bits per target");
+
+    // Hit list: ascending indices, total count reported past max_hits
+    uint32_t hits[count];
+    size_t num_hits = TargetFilterMatch(filter, digests, count, hits, count);
+    ok = num_hits >= count / 3;
+    size_t targets_seen = 0;
+    for (size_t i = 0; i < num_hits && i < count; i++) {
+        ok &= i == 0 || hits[i] > hits[i - 1];
+        ok &= filter.MayContain(digests + hits[i] * 8);
+        targets_seen += hits[i] % 3 == 0;
+    }
+    check(ok && targets_seen == count / 3, "TargetFilterMatch lists every target in order");
+
+    uint32_t few[5];
+    check(TargetFilterMatch(filter, digests, count, few, 5) == num_hits && memcmp(few, hits, sizeof(few)) == 0,
+          "TargetFilterMatch counts past max_hits");
+
+    TargetFilter empty;
+    check(empty.NumBlocks() == 1 && !empty.MayContain(digests), "Empty filter matches nothing");
+
+    delete[] keys;
+    delete[] digests;
+}
+
+static bool accept_all(uint32_t, uint32_t, const void*) { return true; }
+static bool reject_all(uint32_t, uint32_t, const void*) { return false; }
+
+// Records every (h7, h3) pair the match transform reports
+static uint32_t seen_h7[SHA256_LANES], seen_h3[SHA256_LANES];
+static int seen_count;
+static bool record_lane(uint32_t h7, uint32_t h3, const void*) {
+    seen_h7[seen_count] = h7;
+    seen_h3[seen_count] = h3;
+    seen_count++;
+    return seen_count == 3;   // accept lane 2 only
+}
+
+static void test_match_mode() {
+    printf("\nMatch mode (early reject)\n");
+
+    uint32_t block[16][SHA256_LANES], init[8][SHA256_LANES];
+    fill_pattern((uint8_t*)block, sizeof(block), 7);
+    fill_pattern((uint8_t*)init, sizeof(init), 8);
+    uint32_t full[8][SHA256_LANES], state[8][SHA256_LANES];
+    memcpy(full, init, sizeof(full));
+    SHA256TransformLanes(full, block);
+
+    memcpy(state, init, sizeof(state));
+    check(SHA256TransformLanesMatch(state, block, accept_all, NULL) == (1u << SHA256_LANES) - 1 &&
+          memcmp(state, full, sizeof(state)) == 0, "Accepted lanes finish to the full state");
+
+    memcpy(state, init, sizeof(state));
+    check(SHA256TransformLanesMatch(state, block, reject_all, NULL) == 0 &&
+          memcmp(state, init, sizeof(state)) == 0, "Rejected batch leaves the state alone");
+
+    seen_count = 0;
+    memcpy(state, init, sizeof(state));
+    uint32_t mask = SHA256TransformLanesMatch(state, block, record_lane, NULL);
+    bool ok = mask == 4 && seen_count == SHA256_LANES;
+    for (int l = 0; l < SHA256_LANES; l++) {
+        ok &= seen_h7[l] == full[7][l] && seen_h3[l] == full[3][l];
+    }
+    check(ok, "H7 and H3 after round 60 equal the final words");
+
+    // Batch against the full-digest reference, for single and multi-block
+    // messages and partial lane groups
+    const size_t lens[] = {0, 33, 55, 56, 64, 100};
+    const size_t count = 45;
+    uint8_t data[count * 100];
+    uint32_t digests[count * 8];
+    TargetHit hits[count];
+    uint32_t expected[count];
+    for (size_t li = 0; li < sizeof(lens) / sizeof(lens[0]); li++) {
+        size_t len = lens[li];
+        fill_pattern(data, sizeof(data), 100 + (uint32_t)len);
+        for (size_t i = 0; i < count; i++) {
+            SHA256 sha;
+            sha.Update(data + i * len, len);
+            sha.FinalWords(digests + i * 8);
+        }
+        for (int key = TARGET_FILTER_KEY_H0H1; key <= TARGET_FILTER_KEY_H7H3; key++) {
+            TargetFilter filter;
+            filter.Init(count / 5, 16, (TargetFilterKey)key);
+            for (size_t i = 0; i < count; i += 5) {
+                filter.Insert(digests + i * 8);
+            }
+            size_t num_expected = TargetFilterMatch(filter, digests, count, expected, count);
+            size_t num_hits = SHA256MatchBatch(filter, data, len, count, hits, count);
+            ok = num_hits == num_expected;
+            for (size_t i = 0; ok && i < num_hits; i++) {
+                ok &= hits[i].index == expected[i];
+                ok &= memcmp(hits[i].digest, digests + hits[i].index * 8, 32) == 0;
+            }
+            if (!ok) {
+                printf("  len %zu, key %d: %zu hits, expected %zu\n", len, key, num_hits, num_expected);
+                break;
+            }
+        }
+        if (!ok) {
+            break;
+        }
+    }
+    check(ok, "SHA256MatchBatch matches the filter over full digests");
+
+    TargetFilter filter;
+    filter.Init(count, 16, TARGET_FILTER_KEY_H7H3);
+    filter.InsertBatch(digests, count);
+    check(SHA256MatchBatch(filter, data, 100, count, hits, 3) >= count && hits[2].index == 2,
+          "SHA256MatchBatch counts past max_hits");
+}
+
+int main() {
+    printf("═══════════════════════════════════════════════════════════════\n");
+    printf("SHA256 CPU Tests\n");
+    printf("═══════════════════════════════════════════════════════════════\n");
+
+    test_sha256_vectors();
+    test_digest_layout();
+    test_digest_compare();
+    test_ripemd160();
+    test_sha256_lanes();
+    test_hash160();
+    test_key_counter();
+    test_prefix();
+    test_header_sweep();
+    test_node64();
+    test_merkle();
+    test_merkle_tree();
+    test_tagged_hash();
+    test_hmac();
+    test_pbkdf2();
+    test_hkdf();
+    test_sha512_family();
+    test_constexpr();
+    test_shapes();
+    test_arena();
+    test_batch();
+    test_job_manager();
+    test_update_v();
+    test_save_restore();
+    test_target_filter();
+    test_match_mode();
+
+    printf("\n═══════════════════════════════════════════════════════════════\n");
+    if (failures) {
+        printf("❌ %d CPU test(s) failed\n", failures);
+        printf("═══════════════════════════════════════════════════════════════\n");
+        return 1;
+    }
+    printf("✓ All CPU tests passed!\n");
+    printf("═══════════════════════════════════════════════════════════════\n");
+    return 0;
+}